@@ -0,0 +1,74 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#ifndef EXDIR_ARCHIVE_BACKEND_H
+#define EXDIR_ARCHIVE_BACKEND_H
+
+#include <exdir/tree_backend.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace exdir {
+
+// Backend which packs an entire exdir tree into one indexed archive file,
+// instead of one file per yaml or npy file. An existing archive is memory
+// mapped when opened, and entries are read directly out of the mapping.
+// Modifications are held in memory until flush() is called, or until the
+// backend is destroyed, at which point the whole archive is rewritten.
+//
+// Archive layout (all integers are 64 bit little endian):
+//   header : "EXDIRARC", version, index offset, number of entries
+//   data   : contents of every file, each aligned to 64 bytes
+//   index  : for each entry; type (0 dir, 1 file), path length, path,
+//            data offset, data size, entry version
+class ArchiveBackend : public TreeBackend {
+ public:
+  ArchiveBackend(std::filesystem::path i_archive);
+  ~ArchiveBackend();
+
+  // The archive owns a memory mapping, and can therefore not be copied.
+  ArchiveBackend(const ArchiveBackend&) = delete;
+  ArchiveBackend& operator=(const ArchiveBackend&) = delete;
+
+  void prefetch(const std::filesystem::path& p) const override final;
+
+  // Writes all pending modifications to the archive file.
+  void flush();
+
+  // Returns the path to the archive file on disk.
+  const std::filesystem::path& archive_path() const { return archive_; }
+
+ private:
+  // Contents of the archive file, either memory mapped, or read into
+  // buffer when memory mapping is not available.
+  struct Mapping {
+    const char* data = nullptr;
+    std::size_t size = 0;
+    std::vector<char> buffer;
+  };
+
+  // Maps the archive file, without modifying the backend.
+  Mapping map_archive() const;
+
+  // Releases a mapping of the archive file.
+  static void unmap(Mapping& mapping);
+
+  // Reads the index of a mapped archive into a new set of entries, which
+  // refer to the mapping for their contents.
+  std::map<std::string, Entry> read_index(const Mapping& mapping) const;
+
+  std::filesystem::path archive_;
+  Mapping mapping_;
+};  // ArchiveBackend
+
+};      // namespace exdir
+#endif  // EXDIR_ARCHIVE_BACKEND_H
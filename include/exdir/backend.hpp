@@ -0,0 +1,70 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#ifndef EXDIR_BACKEND_H
+#define EXDIR_BACKEND_H
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace exdir {
+
+// Abstract storage layer underneath every Object. All reads and writes of
+// directories, yaml files and npy files go through a Backend, so the same
+// exdir tree may live on a POSIX filesystem, in memory, or in an archive.
+// Implementations must be safe to call from multiple threads at once.
+class Backend {
+ public:
+  virtual ~Backend() = default;
+
+  // Returns true if a file or directory exists at path p.
+  virtual bool exists(const std::filesystem::path& p) const = 0;
+
+  // Returns true if a directory exists at path p.
+  virtual bool is_directory(const std::filesystem::path& p) const = 0;
+
+  // Creates the directory p. Throws if it can not be created.
+  virtual void create_directory(const std::filesystem::path& p) = 0;
+
+  // Returns the names of all files and directories directly within p.
+  virtual std::vector<std::string> list_directory(
+      const std::filesystem::path& p) const = 0;
+
+  // Returns the full contents of the file p.
+  virtual std::string read_file(const std::filesystem::path& p) const = 0;
+
+  // Returns the size of the file p in bytes.
+  virtual std::size_t file_size(const std::filesystem::path& p) const = 0;
+
+  // Reads size bytes, starting at offset in the file p, into buffer.
+  // Throws if the file is shorter than offset + size.
+  virtual void read_bytes(const std::filesystem::path& p, std::size_t offset,
+                          std::size_t size, char* buffer) const = 0;
+
+  // Returns a token which changes whenever the file p is modified, so that
+  // data derived from the file can be recognized as stale. Backends which
+  // can not tell return an empty string, and derived data is not trusted.
+  virtual std::string file_version(const std::filesystem::path& /*p*/) const {
+    return std::string();
+  }
+
+  // Hints that the file p will be read soon, so that the backend may start
+  // fetching it in the background. Does nothing by default.
+  virtual void prefetch(const std::filesystem::path& /*p*/) const {}
+
+  // Replaces the contents of the file p, creating it if needed.
+  virtual void write_file(const std::filesystem::path& p,
+                          const std::string& contents) = 0;
+};  // Backend
+
+};      // namespace exdir
+#endif  // EXDIR_BACKEND_H
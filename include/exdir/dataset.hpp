@@ -18,10 +18,18 @@
 
 namespace exdir {
 
+template<class T>
+class DatasetPrefetcher;
+
 template<class T>
 class Dataset : public Object {
  public:
   ~Dataset() = default;
+  Dataset(const Dataset&) = default;
+  Dataset& operator=(const Dataset&) = default;
+  // Moving a Dataset moves the data, instead of copying it.
+  Dataset(Dataset&&) = default;
+  Dataset& operator=(Dataset&&) = default;
 
   exdir::Raw create_raw(const std::string& name);
 
@@ -35,9 +43,20 @@ class Dataset : public Object {
   NDArray<T> data;
  private:
   // Constructor is private.
-  // Only a Group can create a Dataset.
+  // Only a Group, or a DatasetPrefetcher, can create a Dataset.
   friend class Group;
-  Dataset(std::filesystem::path i_path);
+  friend class DatasetPrefetcher<T>;
+  Dataset(std::filesystem::path i_path, std::shared_ptr<Backend> i_backend);
+
+  // Constructs a Dataset from metadata, raws and data which
+  // have already been loaded.
+  Dataset(std::filesystem::path i_path, std::shared_ptr<Backend> i_backend,
+          Metadata&& i_metadata, std::vector<std::string>&& i_raws,
+          NDArray<T>&& i_data);
+
+  // Returns the names of all raws in the dataset directory at path
+  static std::vector<std::string> find_raws(const Backend& backend,
+                                            const std::filesystem::path& path);
 
   std::vector<std::string> raws_;
 
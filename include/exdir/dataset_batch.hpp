@@ -0,0 +1,168 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#ifndef EXDIR_DATASET_BATCH_H
+#define EXDIR_DATASET_BATCH_H
+
+#include <exdir/backend.hpp>
+#include <exdir/npy.hpp>
+
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace exdir {
+
+// Non-owning view of the data of one dataset held in a DatasetBatch.
+// It is only valid as long as the batch it came from.
+template <class T>
+struct ArrayView {
+  T* data;
+  const std::size_t* shape;
+  std::size_t ndim;
+  std::size_t size;
+  bool c_continuous;
+
+  T& operator[](std::size_t i) const { return data[i]; }
+
+  T* begin() const { return data; }
+  T* end() const { return data + size; }
+
+  // Returns a copy of the data as an NDArray.
+  NDArray<T> to_ndarray() const {
+    return NDArray<T>(std::vector<T>(data, data + size),
+                      std::vector<std::size_t>(shape, shape + ndim),
+                      c_continuous);
+  }
+};
+
+// The data of many datasets, loaded into a single memory arena. Loading
+// many small arrays this way avoids a separate heap allocation for every
+// array, shape, name and Dataset object. All memory is released at once
+// when the batch is cleared or destroyed. A DatasetBatch is obtained
+// from Group::load_datasets.
+template <class T>
+class DatasetBatch {
+ public:
+  // initial_size is the number of bytes requested from the heap for the
+  // first arena block, and must be greater than zero. The arena grows
+  // geometrically from there.
+  DatasetBatch(std::size_t initial_size = 1 << 20)
+      : arena_(make_arena(initial_size)),
+        views_(arena_.get()),
+        names_(arena_.get()) {}
+  ~DatasetBatch() = default;
+
+  // Views point into the arena, so a batch may be moved but not copied.
+  // Containers are tied to their arena, so move assignment is not possible.
+  DatasetBatch(DatasetBatch&&) = default;
+  DatasetBatch& operator=(DatasetBatch&&) = delete;
+  DatasetBatch(const DatasetBatch&) = delete;
+  DatasetBatch& operator=(const DatasetBatch&) = delete;
+
+  // Returns the number of datasets in the batch.
+  std::size_t size() const { return views_.size(); }
+
+  bool empty() const { return views_.empty(); }
+
+  // Returns the data of the i'th dataset.
+  const ArrayView<T>& operator[](std::size_t i) const { return views_[i]; }
+
+  // Returns the name of the i'th dataset.
+  std::string_view name(std::size_t i) const { return names_[i]; }
+
+  typename std::pmr::vector<ArrayView<T>>::const_iterator begin() const {
+    return views_.begin();
+  }
+  typename std::pmr::vector<ArrayView<T>>::const_iterator end() const {
+    return views_.end();
+  }
+
+  // Reserves space for n datasets. Containers in the arena abandon their
+  // old memory whenever they grow, so reserving up front avoids waste.
+  void reserve(std::size_t n) {
+    views_.reserve(n);
+    names_.reserve(n);
+  }
+
+  // Releases the memory of all datasets in the batch.
+  void clear() {
+    // Containers must let go of their arena memory before it is released
+    std::pmr::vector<ArrayView<T>>(arena_.get()).swap(views_);
+    std::pmr::vector<std::pmr::string>(arena_.get()).swap(names_);
+    arena_->release();
+  }
+
+  // Reads the npy file p from backend into the arena, and adds it to the
+  // batch under name.
+  void load(const Backend& backend, const std::filesystem::path& p,
+            const std::string& name) {
+    std::size_t file_size = backend.file_size(p);
+    char* buffer = static_cast<char*>(arena_->allocate(file_size, 64));
+    backend.read_bytes(p, 0, file_size, buffer);
+
+    NpyHeader header = parse_npy_header(buffer, file_size);
+    check_npy_type<T>(header);
+
+    std::size_t n = 1;
+    for (const auto& s : header.shape) n *= s;
+
+    // Data is used in place when aligned, which is the case for all files
+    // written by exdir-cpp or a recent version of numpy.
+    char* data = buffer + header.data_offset;
+    if (header.data_offset % alignof(T) != 0) {
+      char* aligned =
+          static_cast<char*>(arena_->allocate(n * sizeof(T), alignof(T)));
+      std::memcpy(aligned, data, n * sizeof(T));
+      data = aligned;
+    }
+
+    bool little = header.byte_order == '<';
+    if (header.byte_order != '|' && little != host_is_little_endian()) {
+      npy_swap_bytes<T>(data, n);
+    }
+
+    // A 0-d array is stored as a single element
+    std::size_t ndim = header.shape.empty() ? 1 : header.shape.size();
+    std::size_t* shape = static_cast<std::size_t*>(
+        arena_->allocate(ndim * sizeof(std::size_t), alignof(std::size_t)));
+    if (header.shape.empty())
+      shape[0] = 1;
+    else
+      std::memcpy(shape, header.shape.data(), ndim * sizeof(std::size_t));
+
+    views_.push_back(ArrayView<T>{reinterpret_cast<T*>(data), shape, ndim, n,
+                                  !header.fortran_order});
+    names_.emplace_back(name);
+  }
+
+ private:
+  static std::unique_ptr<std::pmr::monotonic_buffer_resource> make_arena(
+      std::size_t initial_size) {
+    if (initial_size == 0) {
+      std::string mssg = "The initial size of a DatasetBatch must be positive.";
+      throw std::runtime_error(mssg);
+    }
+    return std::make_unique<std::pmr::monotonic_buffer_resource>(initial_size);
+  }
+
+  // Held by pointer so that the arena does not move with the batch
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+  std::pmr::vector<ArrayView<T>> views_;
+  std::pmr::vector<std::pmr::string> names_;
+};  // DatasetBatch
+
+};      // namespace exdir
+#endif  // EXDIR_DATASET_BATCH_H
@@ -0,0 +1,201 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#ifndef EXDIR_DATASET_PREFETCHER_H
+#define EXDIR_DATASET_PREFETCHER_H
+
+#include <exdir/dataset.hpp>
+#include <exdir/npy.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace exdir {
+
+// Reads a sequence of datasets in order, while a background thread loads
+// the data and metadata of the datasets which follow. This allows the
+// reading and decoding of the next datasets to overlap with the processing
+// of the current one. At most depth datasets, and memory_budget bytes of
+// data, are held ahead of the reader at once, though a single dataset
+// larger than the budget is still loaded. A DatasetPrefetcher is obtained from Group::prefetch_datasets.
+template <class T>
+class DatasetPrefetcher {
+ public:
+  DatasetPrefetcher(std::shared_ptr<Backend> i_backend,
+                    std::filesystem::path i_path,
+                    std::vector<std::string> i_names, std::size_t i_depth,
+                    std::size_t i_memory_budget)
+      : backend_(i_backend),
+        path_(i_path),
+        names_(std::move(i_names)),
+        depth_(i_depth > 0 ? i_depth : 1),
+        memory_budget_(i_memory_budget),
+        queue_(),
+        queued_bytes_(0),
+        next_(0),
+        stop_(false),
+        mutex_(),
+        loaded_(),
+        consumed_(),
+        worker_() {
+    worker_ = std::thread(&DatasetPrefetcher::load_all, this);
+  }
+
+  ~DatasetPrefetcher() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    consumed_.notify_all();
+    worker_.join();
+  }
+
+  // The background thread refers to the prefetcher, so it may not move.
+  DatasetPrefetcher(const DatasetPrefetcher&) = delete;
+  DatasetPrefetcher& operator=(const DatasetPrefetcher&) = delete;
+
+  // Returns the next dataset, waiting for it to be loaded if needed.
+  // Returns an empty optional once all datasets have been read. If a
+  // dataset failed to load, the error is thrown here, in order.
+  std::optional<Dataset<T>> next() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (next_ == names_.size()) return std::nullopt;
+    loaded_.wait(lock, [this] { return !queue_.empty(); });
+
+    Item item = std::move(queue_.front());
+    queue_.pop_front();
+    queued_bytes_ -= item.bytes;
+    next_++;
+    lock.unlock();
+    consumed_.notify_one();
+
+    if (item.error) std::rethrow_exception(item.error);
+    return Dataset<T>(path_ / item.name, backend_, std::move(item.metadata),
+                      std::move(item.raws), std::move(*item.data));
+  }
+
+  // Input iterator over the remaining datasets, which calls next().
+  class iterator {
+   public:
+    iterator(DatasetPrefetcher* i_prefetcher)
+        : prefetcher_(i_prefetcher), current_() {
+      if (prefetcher_) ++(*this);
+    }
+
+    Dataset<T>& operator*() { return *current_; }
+    Dataset<T>* operator->() { return &(*current_); }
+
+    iterator& operator++() {
+      current_.reset();
+      current_ = prefetcher_->next();
+      if (!current_) prefetcher_ = nullptr;
+      return *this;
+    }
+
+    bool operator==(const iterator& other) const {
+      return prefetcher_ == other.prefetcher_;
+    }
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+   private:
+    DatasetPrefetcher* prefetcher_;
+    std::optional<Dataset<T>> current_;
+  };
+
+  iterator begin() { return iterator(this); }
+  iterator end() { return iterator(nullptr); }
+
+  // Returns the number of datasets which have not yet been read.
+  std::size_t remaining() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return names_.size() - next_;
+  }
+
+ private:
+  struct Item {
+    std::string name;
+    typename Dataset<T>::Metadata metadata;
+    std::vector<std::string> raws;
+    std::optional<NDArray<T>> data;
+    std::size_t bytes;
+    std::exception_ptr error;
+  };
+
+  // Run by the background thread, loads every dataset in order.
+  void load_all() {
+    std::size_t hinted = 0;
+    for (std::size_t i = 0; i < names_.size(); i++) {
+      std::filesystem::path dset_path = path_ / names_[i];
+      std::filesystem::path data_path = dset_path / "data.npy";
+      Item item{names_[i], {}, {}, std::nullopt, 0, nullptr};
+
+      try {
+        item.bytes = backend_->file_size(data_path);
+
+        // Wait for space in the queue, and within the memory budget
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          consumed_.wait(lock, [this, &item] {
+            return stop_ || queue_.empty() ||
+                   (queue_.size() < depth_ &&
+                    queued_bytes_ + item.bytes <= memory_budget_);
+          });
+          if (stop_) return;
+        }
+
+        // Let the backend start on the files which follow this one
+        for (; hinted < std::min(i + depth_ + 1, names_.size()); hinted++) {
+          backend_->prefetch(path_ / names_[hinted] / "data.npy");
+        }
+
+        // All files of the dataset are read here, so that constructing the
+        // Dataset in next() does no I/O at all
+        item.metadata = Dataset<T>::read_metadata(*backend_, dset_path);
+        item.raws = Dataset<T>::find_raws(*backend_, dset_path);
+        item.data = read_npy<T>(*backend_, data_path);
+      } catch (...) {
+        item.error = std::current_exception();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_) return;
+        queued_bytes_ += item.bytes;
+        queue_.push_back(std::move(item));
+      }
+      loaded_.notify_one();
+    }
+  }
+
+  std::shared_ptr<Backend> backend_;
+  std::filesystem::path path_;
+  std::vector<std::string> names_;
+  std::size_t depth_;
+  std::size_t memory_budget_;
+
+  // Loaded datasets which have not yet been read
+  std::deque<Item> queue_;
+  std::size_t queued_bytes_;
+  // Index of the next dataset to be returned by next()
+  std::size_t next_;
+  bool stop_;
+  mutable std::mutex mutex_;
+  std::condition_variable loaded_;
+  std::condition_variable consumed_;
+  std::thread worker_;
+};  // DatasetPrefetcher
+
+};      // namespace exdir
+#endif  // EXDIR_DATASET_PREFETCHER_H
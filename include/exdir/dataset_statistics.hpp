@@ -0,0 +1,454 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#ifndef EXDIR_DATASET_STATISTICS_H
+#define EXDIR_DATASET_STATISTICS_H
+
+#include <yaml-cpp/yaml.h>
+
+#include <exdir/backend.hpp>
+#include <exdir/npy.hpp>
+#include <exdir/thread_pool.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <optional>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define EXDIR_STATISTICS_SSE2
+#endif
+
+namespace exdir {
+
+// Returns v as a double which is no larger than v. Integers with a
+// magnitude above 2^53 may be rounded up when converted, so are nudged.
+template <class T>
+double lower_double(T v) {
+  double d = static_cast<double>(v);
+  if (std::is_integral_v<T> && std::abs(d) >= 9007199254740992.)
+    d = std::nextafter(d, -std::numeric_limits<double>::infinity());
+  return d;
+}
+
+// Returns v as a double which is no smaller than v.
+template <class T>
+double upper_double(T v) {
+  double d = static_cast<double>(v);
+  if (std::is_integral_v<T> && std::abs(d) >= 9007199254740992.)
+    d = std::nextafter(d, std::numeric_limits<double>::infinity());
+  return d;
+}
+
+// Summary of the data of a dataset, which is computed whenever the data
+// is written and stored next to it in statistics.yaml. Besides the global
+// values, the data is split into blocks of block_size elements (in the
+// order they are stored), and the min and max of every block are kept.
+// These allow range queries to skip blocks which can not match.
+struct DatasetStatistics {
+  std::size_t count = 0;      // Number of elements
+  std::size_t nan_count = 0;  // Number of NaN elements
+  // Min, max and mean of all elements which are not NaN. These are NaN if
+  // there are no such elements.
+  double min = std::numeric_limits<double>::quiet_NaN();
+  double max = std::numeric_limits<double>::quiet_NaN();
+  double mean = std::numeric_limits<double>::quiet_NaN();
+  // Backend::file_version of data.npy when the statistics were computed.
+  // Statistics are stale, and are ignored, when this no longer matches.
+  std::string data_version;
+  std::size_t block_size = 0;
+  std::vector<double> block_min;
+  std::vector<double> block_max;
+
+  // Returns true if the value v lies within the bounds of block b.
+  template <class T>
+  bool block_holds(std::size_t b, T v) const {
+    // NaN values are not part of the bounds
+    if (v != v) return true;
+    return lower_double(v) >= block_min[b] && upper_double(v) <= block_max[b];
+  }
+
+  // Returns true if block b may hold a value within [lo, hi].
+  bool block_may_contain(std::size_t b, double lo, double hi) const {
+    // Blocks of only NaN have a NaN min and max, and never match
+    return block_min[b] <= hi && block_max[b] >= lo;
+  }
+
+  // Returns the statistics as a YAML node.
+  YAML::Node to_yaml() const;
+
+  // Reads statistics from a YAML node written by to_yaml.
+  static DatasetStatistics from_yaml(const YAML::Node& node);
+};
+
+// Elements selected from a dataset by Group::get_dataset_range. Indices
+// are the positions of the values in the order the data is stored.
+template <class T>
+struct DatasetSelection {
+  std::vector<std::size_t> indices;
+  std::vector<T> values;
+};
+
+// Number of elements per block of the statistics
+const std::size_t STATISTICS_BLOCK_SIZE = 16384;
+
+// Datasets with fewer bytes than this are summarized on a single thread
+const std::size_t STATISTICS_PARALLEL_BYTES = 1 << 22;
+
+// Returns true if statistics can be computed for T.
+template <class T>
+constexpr bool has_statistics() {
+  return npy_kind<T>() != 'c';
+}
+
+// Summary of one block of elements
+struct BlockSummary {
+  double min;
+  double max;
+  double sum;
+  std::size_t nan_count;
+};
+
+// Returns the summary of the n > 0 elements in data.
+template <class T>
+BlockSummary summarize_block(const T* data, std::size_t n) {
+  // Each lane is independent of the others, which breaks the dependency
+  // between iterations of the main loop. Comparisons with NaN are false,
+  // which skips NaN elements in the min and max without a branch.
+  constexpr std::size_t LANES = 8;
+  T mn[LANES];
+  T mx[LANES];
+  double sum[LANES];
+  std::size_t nans[LANES];
+  for (std::size_t l = 0; l < LANES; l++) {
+    mn[l] = std::numeric_limits<T>::has_infinity
+                ? std::numeric_limits<T>::infinity()
+                : std::numeric_limits<T>::max();
+    mx[l] = std::numeric_limits<T>::has_infinity
+                ? -std::numeric_limits<T>::infinity()
+                : std::numeric_limits<T>::lowest();
+    sum[l] = 0.;
+    nans[l] = 0;
+  }
+
+  std::size_t i = 0;
+  for (; i + LANES <= n; i += LANES) {
+    for (std::size_t l = 0; l < LANES; l++) {
+      T v = data[i + l];
+      bool nan = v != v;
+      nans[l] += nan;
+      mn[l] = v < mn[l] ? v : mn[l];
+      mx[l] = v > mx[l] ? v : mx[l];
+      sum[l] += nan ? 0. : static_cast<double>(v);
+    }
+  }
+  for (; i < n; i++) {
+    T v = data[i];
+    bool nan = v != v;
+    nans[0] += nan;
+    mn[0] = v < mn[0] ? v : mn[0];
+    mx[0] = v > mx[0] ? v : mx[0];
+    sum[0] += nan ? 0. : static_cast<double>(v);
+  }
+
+  BlockSummary summary{lower_double(mn[0]), upper_double(mx[0]), 0., 0};
+  for (std::size_t l = 0; l < LANES; l++) {
+    summary.min = std::min(summary.min, lower_double(mn[l]));
+    summary.max = std::max(summary.max, upper_double(mx[l]));
+    summary.sum += sum[l];
+    summary.nan_count += nans[l];
+  }
+  if (summary.nan_count == n) {
+    summary.min = std::numeric_limits<double>::quiet_NaN();
+    summary.max = std::numeric_limits<double>::quiet_NaN();
+  }
+  return summary;
+}
+
+#ifdef EXDIR_STATISTICS_SSE2
+// Combines the summaries a and b of two parts of the same block.
+inline BlockSummary merge_block_summaries(const BlockSummary& a,
+                                          const BlockSummary& b) {
+  // fmin and fmax ignore the NaN of parts without values
+  return {std::fmin(a.min, b.min), std::fmax(a.max, b.max), a.sum + b.sum,
+          a.nan_count + b.nan_count};
+}
+
+// Compilers do not vectorize floating point min, max and sum reductions
+// without relaxed math, so float and double blocks are summarized with
+// SSE2. minpd and maxpd return their second operand when either one is
+// NaN, so the accumulators, which are never NaN, skip NaN elements.
+inline BlockSummary summarize_block(const double* data, std::size_t n) {
+  __m128d mn = _mm_set1_pd(std::numeric_limits<double>::infinity());
+  __m128d mx = _mm_set1_pd(-std::numeric_limits<double>::infinity());
+  __m128d sum = _mm_setzero_pd();
+  __m128i nans = _mm_setzero_si128();
+
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128d v = _mm_loadu_pd(data + i);
+    __m128d nan = _mm_cmpunord_pd(v, v);
+    mn = _mm_min_pd(v, mn);
+    mx = _mm_max_pd(v, mx);
+    sum = _mm_add_pd(sum, _mm_andnot_pd(nan, v));
+    // NaN lanes of the mask are all ones, which is -1
+    nans = _mm_sub_epi64(nans, _mm_castpd_si128(nan));
+  }
+
+  // Blocks too short for a single vector are summarized as any other
+  if (i == 0) return summarize_block<double>(data, n);
+
+  double mn_l[2], mx_l[2], sum_l[2];
+  std::int64_t nans_l[2];
+  _mm_storeu_pd(mn_l, mn);
+  _mm_storeu_pd(mx_l, mx);
+  _mm_storeu_pd(sum_l, sum);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(nans_l), nans);
+
+  std::size_t nan_count = static_cast<std::size_t>(nans_l[0] + nans_l[1]);
+  BlockSummary summary{std::min(mn_l[0], mn_l[1]), std::max(mx_l[0], mx_l[1]),
+                       sum_l[0] + sum_l[1], nan_count};
+  if (nan_count == i) {
+    summary.min = std::numeric_limits<double>::quiet_NaN();
+    summary.max = std::numeric_limits<double>::quiet_NaN();
+  }
+  if (i < n)
+    summary = merge_block_summaries(
+        summary, summarize_block<double>(data + i, n - i));
+  return summary;
+}
+
+inline BlockSummary summarize_block(const float* data, std::size_t n) {
+  __m128 mn = _mm_set1_ps(std::numeric_limits<float>::infinity());
+  __m128 mx = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+  __m128d sum_lo = _mm_setzero_pd();
+  __m128d sum_hi = _mm_setzero_pd();
+  __m128i nans = _mm_setzero_si128();
+
+  // The sum is kept in double, as for the other types
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 v = _mm_loadu_ps(data + i);
+    __m128 nan = _mm_cmpunord_ps(v, v);
+    mn = _mm_min_ps(v, mn);
+    mx = _mm_max_ps(v, mx);
+    __m128 values = _mm_andnot_ps(nan, v);
+    sum_lo = _mm_add_pd(sum_lo, _mm_cvtps_pd(values));
+    sum_hi = _mm_add_pd(sum_hi, _mm_cvtps_pd(_mm_movehl_ps(values, values)));
+    nans = _mm_sub_epi32(nans, _mm_castps_si128(nan));
+  }
+
+  // Blocks too short for a single vector are summarized as any other
+  if (i == 0) return summarize_block<float>(data, n);
+
+  float mn_l[4], mx_l[4];
+  double sum_l[2];
+  std::int32_t nans_l[4];
+  _mm_storeu_ps(mn_l, mn);
+  _mm_storeu_ps(mx_l, mx);
+  _mm_storeu_pd(sum_l, _mm_add_pd(sum_lo, sum_hi));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(nans_l), nans);
+
+  // Each lane counts at most n / 4 NaN, far below 2^31 for any block
+  BlockSummary summary{std::numeric_limits<double>::infinity(),
+                       -std::numeric_limits<double>::infinity(),
+                       sum_l[0] + sum_l[1], 0};
+  for (std::size_t l = 0; l < 4; l++) {
+    summary.min = std::min(summary.min, static_cast<double>(mn_l[l]));
+    summary.max = std::max(summary.max, static_cast<double>(mx_l[l]));
+    summary.nan_count += static_cast<std::uint32_t>(nans_l[l]);
+  }
+  if (summary.nan_count == i) {
+    summary.min = std::numeric_limits<double>::quiet_NaN();
+    summary.max = std::numeric_limits<double>::quiet_NaN();
+  }
+  if (i < n)
+    summary = merge_block_summaries(
+        summary, summarize_block<float>(data + i, n - i));
+  return summary;
+}
+#endif
+
+// Function which returns the pool to summarize blocks on, such as
+// default_thread_pool. It is only called for data large enough to use it,
+// so that small writes never start the threads of the pool.
+using ThreadPoolGetter = ThreadPool& (*)();
+
+// Computes the statistics of the n elements in data. Blocks are
+// summarized concurrently on the pool from get_pool when it is provided
+// and the data is large, unless called from a pool thread, where waiting
+// could deadlock.
+template <class T>
+DatasetStatistics compute_statistics(const T* data, std::size_t n,
+                                     ThreadPoolGetter get_pool = nullptr) {
+  DatasetStatistics stats;
+  stats.count = n;
+  stats.block_size = STATISTICS_BLOCK_SIZE;
+
+  std::size_t n_blocks = (n + STATISTICS_BLOCK_SIZE - 1) / STATISTICS_BLOCK_SIZE;
+  std::vector<BlockSummary> blocks(n_blocks);
+  auto summarize = [&](std::size_t first, std::size_t last) {
+    for (std::size_t b = first; b < last; b++) {
+      std::size_t start = b * STATISTICS_BLOCK_SIZE;
+      std::size_t len = std::min(STATISTICS_BLOCK_SIZE, n - start);
+      blocks[b] = summarize_block(data + start, len);
+    }
+  };
+
+  ThreadPool* pool = nullptr;
+  if (get_pool && n_blocks > 1 && !ThreadPool::in_worker_thread() &&
+      n * sizeof(T) >= STATISTICS_PARALLEL_BYTES) {
+    pool = &get_pool();
+  }
+
+  if (pool && pool->size() > 1) {
+    std::size_t n_tasks = std::min(pool->size(), n_blocks);
+    std::vector<std::future<void>> tasks;
+    for (std::size_t t = 0; t < n_tasks; t++) {
+      std::size_t first = n_blocks * t / n_tasks;
+      std::size_t last = n_blocks * (t + 1) / n_tasks;
+      tasks.push_back(pool->submit([&summarize, first, last] {
+        summarize(first, last);
+      }));
+    }
+    for (auto& task : tasks) task.wait();
+    for (auto& task : tasks) task.get();
+  } else {
+    summarize(0, n_blocks);
+  }
+
+  double sum = 0.;
+  stats.block_min.reserve(n_blocks);
+  stats.block_max.reserve(n_blocks);
+  for (const auto& block : blocks) {
+    stats.block_min.push_back(block.min);
+    stats.block_max.push_back(block.max);
+    sum += block.sum;
+    stats.nan_count += block.nan_count;
+    // fmin and fmax ignore the NaN of blocks without values
+    stats.min = std::fmin(stats.min, block.min);
+    stats.max = std::fmax(stats.max, block.max);
+  }
+  if (stats.count > stats.nan_count) {
+    stats.mean = sum / static_cast<double>(stats.count - stats.nan_count);
+  }
+  return stats;
+}
+
+// Computes the statistics of npy, the contents of data.npy in the
+// directory dir, and writes them to dir/statistics.yaml. Nothing is
+// written for types without statistics. get_pool is passed on to
+// compute_statistics.
+template <class T>
+void write_npy_statistics(Backend& backend, const std::filesystem::path& dir,
+                          const std::string& npy,
+                          ThreadPoolGetter get_pool = nullptr) {
+  if constexpr (has_statistics<T>()) {
+    NpyHeader header = parse_npy_header(npy.data(), npy.size());
+    check_npy_type<T>(header);
+
+    std::size_t n = 1;
+    for (const auto& s : header.shape) n *= s;
+
+    // The data is only used in place when it is aligned, and in the byte
+    // order of the host, which is the case for anything from npy_encode.
+    const char* data = npy.data() + header.data_offset;
+    std::vector<T> copy;
+    bool little = header.byte_order == '<';
+    if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) != 0 ||
+        (header.byte_order != '|' && little != host_is_little_endian())) {
+      copy.resize(n);
+      std::memcpy(copy.data(), data, n * sizeof(T));
+      if (header.byte_order != '|' && little != host_is_little_endian())
+        npy_swap_bytes<T>(reinterpret_cast<char*>(copy.data()), n);
+      data = reinterpret_cast<const char*>(copy.data());
+    }
+
+    DatasetStatistics stats =
+        compute_statistics(reinterpret_cast<const T*>(data), n, get_pool);
+    stats.data_version = backend.file_version(dir / "data.npy");
+    backend.write_file(dir / "statistics.yaml", YAML::Dump(stats.to_yaml()));
+  } else {
+    (void)backend;
+    (void)dir;
+    (void)npy;
+    (void)get_pool;
+  }
+}
+
+// Reads the statistics of the dataset in the directory dir. Returns an
+// empty optional if there are none, or if they are stale.
+std::optional<DatasetStatistics> read_statistics(
+    const Backend& backend, const std::filesystem::path& dir);
+
+// Returns all elements of the npy file p which are within [lo, hi]. When
+// stats are provided, only the blocks which may match are read. Every
+// value which is read is checked against the bounds of its block, and if
+// any lies outside, the stats do not describe the file, and the whole
+// file is read instead.
+template <class T>
+DatasetSelection<T> read_npy_range(const Backend& backend,
+                                   const std::filesystem::path& p,
+                                   const std::optional<DatasetStatistics>& stats,
+                                   double lo, double hi) {
+  static_assert(has_statistics<T>(), "Range reads require an ordered type.");
+
+  NpyHeader header = read_npy_header(backend, p);
+  check_npy_type<T>(header);
+  bool swap = header.byte_order != '|' &&
+              (header.byte_order == '<') != host_is_little_endian();
+
+  std::size_t n = 1;
+  for (const auto& s : header.shape) n *= s;
+
+  // Without statistics, the whole array is one block which must be read
+  std::size_t block_size = n;
+  std::size_t n_blocks = n > 0 ? 1 : 0;
+  if (stats && stats->count == n && stats->block_size > 0 &&
+      stats->block_min.size() == (n + stats->block_size - 1) / stats->block_size) {
+    block_size = stats->block_size;
+    n_blocks = stats->block_min.size();
+  }
+
+  DatasetSelection<T> selection;
+  std::vector<T> block;
+  for (std::size_t b = 0; b < n_blocks; b++) {
+    if (block_size != n && !stats->block_may_contain(b, lo, hi)) continue;
+
+    std::size_t start = b * block_size;
+    std::size_t len = std::min(block_size, n - start);
+    block.resize(len);
+    backend.read_bytes(p, header.data_offset + start * sizeof(T),
+                       len * sizeof(T), reinterpret_cast<char*>(block.data()));
+    if (swap) npy_swap_bytes<T>(reinterpret_cast<char*>(block.data()), len);
+
+    if (block_size != n) {
+      for (std::size_t i = 0; i < len; i++) {
+        if (!stats->block_holds(b, block[i]))
+          return read_npy_range<T>(backend, p, std::nullopt, lo, hi);
+      }
+    }
+
+    for (std::size_t i = 0; i < len; i++) {
+      double v = static_cast<double>(block[i]);
+      if (v >= lo && v <= hi) {
+        selection.indices.push_back(start + i);
+        selection.values.push_back(block[i]);
+      }
+    }
+  }
+  return selection;
+}
+
+};      // namespace exdir
+#endif  // EXDIR_DATASET_STATISTICS_H
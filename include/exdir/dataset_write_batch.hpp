@@ -0,0 +1,101 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#ifndef EXDIR_DATASET_WRITE_BATCH_H
+#define EXDIR_DATASET_WRITE_BATCH_H
+
+#include <exdir/dataset_statistics.hpp>
+#include <exdir/npy.hpp>
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace exdir {
+
+// List of new datasets to be written together by Group::create_datasets.
+// Arrays of different types may be mixed in the same batch. The batch
+// only refers to the arrays, which must therefore outlive the write.
+class DatasetWriteBatch {
+ public:
+  DatasetWriteBatch() = default;
+  ~DatasetWriteBatch() = default;
+
+  // Adds a new dataset called <name>, which will contain data.
+  template <class T>
+  void add(const std::string& name, const NDArray<T>& data) {
+    const NDArray<T>* array = &data;
+    entries_.push_back(Entry{
+        name, data.size() * sizeof(T),
+        [array]() { return npy_encode(*array); },
+        [](Backend& backend, const std::filesystem::path& dir,
+           const std::string& npy) { write_npy_statistics<T>(backend, dir, npy); }});
+  }
+
+  // The batch only refers to data, so temporaries would dangle.
+  template <class T>
+  void add(const std::string& name, NDArray<T>&& data) = delete;
+
+  // Returns the number of datasets in the batch.
+  std::size_t size() const { return entries_.size(); }
+
+  bool empty() const { return entries_.empty(); }
+
+  void clear() { entries_.clear(); }
+
+ private:
+  friend class Group;
+
+  struct Entry {
+    std::string name;
+    // Approximate size of the data in bytes
+    std::size_t bytes;
+    // Returns the contents of the npy file
+    std::function<std::string()> encode;
+    // Writes the statistics of the npy file
+    std::function<void(Backend&, const std::filesystem::path&,
+                       const std::string&)> summarize;
+  };
+
+  std::vector<Entry> entries_;
+};  // DatasetWriteBatch
+
+// Thrown by Group::create_datasets once all datasets have been attempted,
+// if any of them could not be written.
+class BatchWriteError : public std::runtime_error {
+ public:
+  BatchWriteError(std::vector<std::pair<std::string, std::string>> i_failures)
+      : std::runtime_error(make_message(i_failures)),
+        failures_(std::move(i_failures)) {}
+
+  // Returns the name of each dataset which failed, with its error message.
+  const std::vector<std::pair<std::string, std::string>>& failures() const {
+    return failures_;
+  }
+
+ private:
+  static std::string make_message(
+      const std::vector<std::pair<std::string, std::string>>& failures) {
+    std::string mssg =
+        std::to_string(failures.size()) + " dataset(s) could not be written:";
+    for (const auto& failure : failures) {
+      mssg += "\n  " + failure.first + ": " + failure.second;
+    }
+    return mssg;
+  }
+
+  std::vector<std::pair<std::string, std::string>> failures_;
+};  // BatchWriteError
+
+};      // namespace exdir
+#endif  // EXDIR_DATASET_WRITE_BATCH_H
@@ -13,10 +13,20 @@
 #define EXDIR_H
 
 #include <exdir/ndarray.hpp>
+#include <exdir/archive_backend.hpp>
+#include <exdir/backend.hpp>
 #include <exdir/dataset.hpp>
+#include <exdir/dataset_batch.hpp>
+#include <exdir/dataset_prefetcher.hpp>
+#include <exdir/dataset_statistics.hpp>
+#include <exdir/dataset_write_batch.hpp>
 #include <exdir/file.hpp>
 #include <exdir/group.hpp>
+#include <exdir/memory_backend.hpp>
 #include <exdir/object.hpp>
+#include <exdir/posix_backend.hpp>
 #include <exdir/raw.hpp>
+#include <exdir/thread_pool.hpp>
+#include <exdir/tree_backend.hpp>
 
 #endif  // EXDIR_H
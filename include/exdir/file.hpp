@@ -13,20 +13,25 @@
 #define EXDIR_FILE_H
 
 #include <exdir/group.hpp>
+#include <exdir/posix_backend.hpp>
 
 namespace exdir {
 
 class File : public Group {
  public:
-  File(std::filesystem::path i_path);
+  File(std::filesystem::path i_path,
+       std::shared_ptr<Backend> i_backend = std::make_shared<PosixBackend>());
   ~File() = default;
 
   // File has no special method compared to Group
 };
 
 //========================================================
-// Non Member function to create a new Exdir file
-File create_file(std::filesystem::path name);
+// Non Member function to create a new Exdir file. By default the file is
+// created on the filesystem, but any other Backend may be provided.
+File create_file(
+    std::filesystem::path name,
+    std::shared_ptr<Backend> backend = std::make_shared<PosixBackend>());
 
 };      // namespace exdir
 #endif  // EXDIR_FILE_H
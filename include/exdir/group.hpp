@@ -13,8 +13,16 @@
 #define EXDIR_GROUP_H
 
 #include <exdir/dataset.hpp>
+#include <exdir/dataset_batch.hpp>
+#include <exdir/dataset_prefetcher.hpp>
+#include <exdir/dataset_statistics.hpp>
+#include <exdir/dataset_write_batch.hpp>
+#include <exdir/npy.hpp>
 #include <exdir/raw.hpp>
 #include <exdir/object.hpp>
+#include <exdir/thread_pool.hpp>
+
+#include <algorithm>
 
 namespace exdir {
 
@@ -33,23 +41,20 @@ class Group : public Object {
   template <class T>
   exdir::Dataset<T> create_dataset(const std::string& name, const exdir::NDArray<T>& data) {
     // Make sure directory does not yet exists
-    if (!std::filesystem::exists(path_ / name)) {
+    if (!backend_->exists(path_ / name)) {
       // Make directory
-      std::filesystem::create_directory(path_ / name);
+      backend_->create_directory(path_ / name);
 
       // Make exdir.yaml file for directory
-      std::ofstream exdir_yaml(path_ / name / "exdir.yaml");
-      exdir_yaml << "exdir:\n";
-      // TODO put version in a header eventuall
-      exdir_yaml << "  version: " << 1 << "\n";
-      exdir_yaml << "  type: \"dataset\"";
-      exdir_yaml.close();
+      backend_->write_file(path_ / name / "exdir.yaml", exdir_yaml("dataset"));
 
       // Add raw name to raws_ for latter
       datasets_.push_back(name);
 
-      // Write data to data.npy
-      data.save((path_ / name / "data.npy").string());
+      // Write data to data.npy, and its summary to statistics.yaml
+      std::string npy = npy_encode(data);
+      backend_->write_file(path_ / name / "data.npy", npy);
+      write_npy_statistics<T>(*backend_, path_ / name, npy, default_thread_pool);
 
     } else {
       std::string mssg =
@@ -60,6 +65,15 @@ class Group : public Object {
     return get_dataset<T>(name);
   }
 
+  // Create all datasets in batch within the current group. The datasets
+  // are written concurrently on pool, while keeping at most
+  // <max_inflight_bytes> of data being written at once. Every dataset is
+  // attempted, after which a BatchWriteError is thrown listing any which
+  // could not be written.
+  void create_datasets(const exdir::DatasetWriteBatch& batch,
+                       exdir::ThreadPool& pool = exdir::default_thread_pool(),
+                       std::size_t max_inflight_bytes = 1 << 30);
+
   // Retrieve the groupe called <name> from current group
   Group get_group(const std::string& name) const;
 
@@ -72,7 +86,7 @@ class Group : public Object {
     // Make sure in datasets_
     for (const auto& dset : datasets_) {
       if (name == dset) {
-        return exdir::Dataset<T>(path_ / name);
+        return exdir::Dataset<T>(path_ / name, backend_);
       }
     }
     // throw error, wasn't a valid Dataset
@@ -81,6 +95,66 @@ class Group : public Object {
   }
 
 
+  // Loads the data of the datasets called <names> into a single
+  // DatasetBatch, without creating a Dataset object for each one.
+  template <class T>
+  exdir::DatasetBatch<T> load_datasets(const std::vector<std::string>& names,
+                                       std::size_t initial_size = 1 << 20) const {
+    exdir::DatasetBatch<T> batch(initial_size);
+    batch.reserve(names.size());
+    for (const auto& name : names) {
+      if (std::find(datasets_.begin(), datasets_.end(), name) == datasets_.end()) {
+        std::string mssg = "The Dataset " + name + " is not a member of this Group.";
+        throw std::runtime_error(mssg);
+      }
+      batch.load(*backend_, path_ / name / "data.npy", name);
+    }
+    return batch;
+  }
+
+  // Loads the data of all member datasets into a single DatasetBatch.
+  template <class T>
+  exdir::DatasetBatch<T> load_datasets(std::size_t initial_size = 1 << 20) const {
+    return load_datasets<T>(datasets_, initial_size);
+  }
+
+  // Returns a DatasetPrefetcher which reads the datasets called <names>
+  // in order, loading up to <depth> datasets, and at most <memory_budget>
+  // bytes, ahead of the reader in a background thread.
+  template <class T>
+  exdir::DatasetPrefetcher<T> prefetch_datasets(const std::vector<std::string>& names,
+                                                std::size_t depth = 4,
+                                                std::size_t memory_budget = 1 << 28) const {
+    for (const auto& name : names) {
+      if (std::find(datasets_.begin(), datasets_.end(), name) == datasets_.end()) {
+        std::string mssg = "The Dataset " + name + " is not a member of this Group.";
+        throw std::runtime_error(mssg);
+      }
+    }
+    return exdir::DatasetPrefetcher<T>(backend_, path_, names, depth, memory_budget);
+  }
+
+  // Returns a DatasetPrefetcher which reads all member datasets in order.
+  template <class T>
+  exdir::DatasetPrefetcher<T> prefetch_datasets(std::size_t depth = 4,
+                                                std::size_t memory_budget = 1 << 28) const {
+    return prefetch_datasets<T>(datasets_, depth, memory_budget);
+  }
+
+  // Returns the statistics of the dataset called <name>, without reading
+  // its data. Returns an empty optional if the dataset has no statistics,
+  // or if its data was modified outside of exdir-cpp since they were made.
+  std::optional<exdir::DatasetStatistics> get_statistics(const std::string& name) const;
+
+  // Returns all elements of the dataset called <name> within [lo, hi].
+  // Only the blocks of data which may hold such values are read.
+  template <class T>
+  exdir::DatasetSelection<T> get_dataset_range(const std::string& name, double lo,
+                                               double hi) const {
+    return read_npy_range<T>(*backend_, path_ / name / "data.npy",
+                             get_statistics(name), lo, hi);
+  }
+
   // Get vector of keys for member groups
   const std::vector<std::string>& member_groups() const {return groups_;}
 
@@ -93,7 +167,7 @@ class Group : public Object {
  protected:
   // Constructor is private.
   // Only a File or another Group can create an new group.
-  Group(std::filesystem::path i_path);
+  Group(std::filesystem::path i_path, std::shared_ptr<Backend> i_backend);
 
   std::vector<std::string> groups_;
   std::vector<std::string> raws_;
@@ -0,0 +1,28 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#ifndef EXDIR_MEMORY_BACKEND_H
+#define EXDIR_MEMORY_BACKEND_H
+
+#include <exdir/tree_backend.hpp>
+
+namespace exdir {
+
+// Backend which keeps the entire exdir tree in memory. Nothing is ever
+// written to disk, which makes it useful for scratch data and unit tests.
+class MemoryBackend : public TreeBackend {
+ public:
+  MemoryBackend() = default;
+  ~MemoryBackend() = default;
+};  // MemoryBackend
+
+};      // namespace exdir
+#endif  // EXDIR_MEMORY_BACKEND_H
@@ -0,0 +1,176 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#ifndef EXDIR_NPY_H
+#define EXDIR_NPY_H
+
+#include <exdir/backend.hpp>
+#include <exdir/ndarray.hpp>
+
+#include <algorithm>
+#include <complex>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace exdir {
+
+// Information held in the header of a Numpy npy file.
+struct NpyHeader {
+  char byte_order;  // '<' little endian, '>' big endian, '|' not applicable
+  char kind;        // 'i', 'u', 'f', 'c', etc.
+  std::size_t item_size;
+  bool fortran_order;
+  std::vector<std::size_t> shape;
+  // Offset of the first data byte from the start of the file
+  std::size_t data_offset;
+};
+
+// Parses the header of an npy file held in data. Throws if the
+// header is invalid, or if size is too small to contain the data.
+NpyHeader parse_npy_header(const char* data, std::size_t size);
+
+// Parses an npy header held in data, where file_size is the size of the
+// complete file, of which only the first size bytes are in data.
+NpyHeader parse_npy_header(const char* data, std::size_t size,
+                           std::size_t file_size);
+
+// Reads and parses only the header of the npy file p.
+NpyHeader read_npy_header(const Backend& backend,
+                          const std::filesystem::path& p);
+
+// Returns a complete npy header, padded so the data which follows
+// is aligned to 64 bytes.
+std::string make_npy_header(char kind, std::size_t item_size,
+                            bool fortran_order,
+                            const std::vector<std::size_t>& shape);
+
+// Returns true if the host stores numbers in little endian.
+bool host_is_little_endian();
+
+// Returns the npy type kind character of T.
+template <class T>
+constexpr char npy_kind() {
+  if constexpr (std::is_same_v<T, std::complex<float>> ||
+                std::is_same_v<T, std::complex<double>>)
+    return 'c';
+  else if constexpr (std::is_floating_point_v<T>)
+    return 'f';
+  else if constexpr (std::is_signed_v<T>)
+    return 'i';
+  else
+    return 'u';
+}
+
+// Throws if the npy header does not describe an array of T.
+template <class T>
+void check_npy_type(const NpyHeader& header) {
+  bool kind_ok = header.kind == npy_kind<T>();
+  // Single byte types are often stored as strings or bools
+  if (sizeof(T) == 1) kind_ok = kind_ok || header.kind == 'i' ||
+                                header.kind == 'u' || header.kind == 'S' ||
+                                header.kind == 'b';
+  if (!kind_ok || header.item_size != sizeof(T)) {
+    std::string mssg = "npy data type " + std::string(1, header.kind) +
+                       std::to_string(header.item_size) +
+                       " does not match the requested type.";
+    throw std::runtime_error(mssg);
+  }
+}
+
+// Reverses the byte order of n elements of type T in place.
+template <class T>
+void npy_swap_bytes(char* data, std::size_t n) {
+  // Complex numbers are swapped one component at a time
+  std::size_t word = npy_kind<T>() == 'c' ? sizeof(T) / 2 : sizeof(T);
+  if (word == 1) return;
+  for (std::size_t i = 0; i < n * sizeof(T); i += word) {
+    std::reverse(data + i, data + i + word);
+  }
+}
+
+// Returns the contents of an npy file containing array.
+template <class T>
+std::string npy_encode(const NDArray<T>& array) {
+  std::string out = make_npy_header(npy_kind<T>(), sizeof(T),
+                                    !array.c_continuous(), array.shape());
+  std::size_t header_size = out.size();
+  out.resize(header_size + array.size() * sizeof(T));
+  char* dest = &out[header_size];
+  for (std::size_t i = 0; i < array.size(); i++) {
+    std::memcpy(dest + i * sizeof(T), &array[i], sizeof(T));
+  }
+  return out;
+}
+
+// Returns the number of elements of the array described by header.
+inline std::size_t npy_count(const NpyHeader& header) {
+  std::size_t n = 1;
+  for (const auto& s : header.shape) n *= s;
+  return n;
+}
+
+// Returns the array described by header, holding the raw values read
+// from the npy file, which are put in the byte order of the host.
+template <class T>
+NDArray<T> npy_make_array(const NpyHeader& header, std::vector<T>&& values) {
+  std::size_t n = values.size();
+  bool little = header.byte_order == '<';
+  if (header.byte_order != '|' && little != host_is_little_endian()) {
+    npy_swap_bytes<T>(reinterpret_cast<char*>(values.data()), n);
+  }
+
+  // A 0-d array is stored as a single element
+  std::vector<std::size_t> shape = header.shape;
+  if (shape.empty()) shape.push_back(1);
+
+  return NDArray<T>(std::move(values), shape, !header.fortran_order);
+}
+
+// Reads an array of T from the contents of an npy file.
+template <class T>
+NDArray<T> npy_decode(const char* data, std::size_t size) {
+  NpyHeader header = parse_npy_header(data, size);
+  check_npy_type<T>(header);
+
+  std::size_t n = npy_count(header);
+  std::vector<T> values(n);
+  if (n > 0) {
+    std::memcpy(values.data(), data + header.data_offset, n * sizeof(T));
+  }
+  return npy_make_array(header, std::move(values));
+}
+
+template <class T>
+NDArray<T> npy_decode(const std::string& contents) {
+  return npy_decode<T>(contents.data(), contents.size());
+}
+
+// Reads an array of T from the npy file p. The data is read directly
+// into the array, without holding a copy of the whole file.
+template <class T>
+NDArray<T> read_npy(const Backend& backend, const std::filesystem::path& p) {
+  NpyHeader header = read_npy_header(backend, p);
+  check_npy_type<T>(header);
+
+  std::size_t n = npy_count(header);
+  std::vector<T> values(n);
+  if (n > 0) {
+    backend.read_bytes(p, header.data_offset, n * sizeof(T),
+                       reinterpret_cast<char*>(values.data()));
+  }
+  return npy_make_array(header, std::move(values));
+}
+
+};      // namespace exdir
+#endif  // EXDIR_NPY_H
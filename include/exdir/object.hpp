@@ -14,9 +14,12 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include <exdir/backend.hpp>
+
 #include <exception>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <string>
 
 namespace exdir {
@@ -27,6 +30,13 @@ class Object {
 
   virtual ~Object() {write();}
 
+  Object(const Object&) = default;
+  Object& operator=(const Object&) = default;
+  // A moved from object is left without a backend, so that destroying it
+  // writes nothing.
+  Object(Object&& other) = default;
+  Object& operator=(Object&& other) = default;
+
   // Returns true if the object is a file.
   bool is_file() const {
     return type_ == Type::File ? true : false;
@@ -58,6 +68,9 @@ class Object {
   // Returns the std::filesystem::path to the object from the root.
   const std::filesystem::path& path() const { return path_; }
 
+  // Returns the Backend which stores the object.
+  const std::shared_ptr<Backend>& backend() const { return backend_; }
+
   // Returns true if the two objects have the same path.
   bool operator==(const Object& obj) const {
     return (path_.relative_path() == obj.path().relative_path());
@@ -72,14 +85,34 @@ class Object {
   YAML::Node attrs;
 
  protected:
-  Object(std::filesystem::path i_path);
+  // Contents of the yaml files of an object, which may be read
+  // before the object is constructed.
+  struct Metadata {
+    bool has_exdir_yaml = false;
+    YAML::Node exdir_info;
+    YAML::Node attrs;
+  };
+
+  // Reads the yaml files of the object at path.
+  static Metadata read_metadata(const Backend& backend,
+                                const std::filesystem::path& path);
+
+  Object(std::filesystem::path i_path, std::shared_ptr<Backend> i_backend);
+  Object(std::filesystem::path i_path, std::shared_ptr<Backend> i_backend,
+         Metadata&& i_metadata);
   Type type_;
   std::filesystem::path path_;
+  std::shared_ptr<Backend> backend_;
   std::string name_;
   // Exidr info stored in a yaml node
   YAML::Node exdir_info;
 
 };  // object
+
+// Returns the contents of the exdir.yaml file for an object of <type>,
+// which is one of "file", "group", "dataset" or "raw".
+std::string exdir_yaml(const std::string& type);
+
 };  // namespace exdir
 
 #endif  // EXDIR_OBJECT_H
@@ -0,0 +1,51 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#ifndef EXDIR_POSIX_BACKEND_H
+#define EXDIR_POSIX_BACKEND_H
+
+#include <exdir/backend.hpp>
+
+namespace exdir {
+
+// Default Backend, which stores the exdir tree directly on the
+// filesystem of the users computer.
+class PosixBackend : public Backend {
+ public:
+  PosixBackend() = default;
+  ~PosixBackend() = default;
+
+  bool exists(const std::filesystem::path& p) const override final;
+
+  bool is_directory(const std::filesystem::path& p) const override final;
+
+  void create_directory(const std::filesystem::path& p) override final;
+
+  std::vector<std::string> list_directory(
+      const std::filesystem::path& p) const override final;
+
+  std::string read_file(const std::filesystem::path& p) const override final;
+
+  std::size_t file_size(const std::filesystem::path& p) const override final;
+
+  void read_bytes(const std::filesystem::path& p, std::size_t offset,
+                  std::size_t size, char* buffer) const override final;
+
+  std::string file_version(const std::filesystem::path& p) const override final;
+
+  void prefetch(const std::filesystem::path& p) const override final;
+
+  void write_file(const std::filesystem::path& p,
+                  const std::string& contents) override final;
+};  // PosixBackend
+
+};      // namespace exdir
+#endif  // EXDIR_POSIX_BACKEND_H
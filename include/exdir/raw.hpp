@@ -13,12 +13,14 @@
 #define EXDIR_RAW_H
 
 #include <exdir/object.hpp>
+#include <exdir/posix_backend.hpp>
 
 namespace exdir {
 
 class Raw : public Object {
  public:
-  Raw(std::filesystem::path i_path);
+  Raw(std::filesystem::path i_path,
+      std::shared_ptr<Backend> i_backend = std::make_shared<PosixBackend>());
   ~Raw() = default;
 
   // A Raw cannot have any daughter nodes, only member files,
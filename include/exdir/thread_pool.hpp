@@ -0,0 +1,63 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#ifndef EXDIR_THREAD_POOL_H
+#define EXDIR_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace exdir {
+
+// Fixed size pool of worker threads, which run submitted tasks in the
+// order they were submitted. Tasks must not wait on other tasks of the
+// same pool, as this may deadlock once all workers are busy.
+class ThreadPool {
+ public:
+  // A pool with zero threads uses one thread per hardware thread.
+  ThreadPool(std::size_t n_threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Queues task to be run, returning a future which becomes ready once
+  // the task has finished, and which holds any exception it threw.
+  std::future<void> submit(std::function<void()> task);
+
+  // Returns the number of worker threads.
+  std::size_t size() const { return workers_.size(); }
+
+  // Returns true if called from a worker thread of any ThreadPool.
+  static bool in_worker_thread();
+
+ private:
+  // Run by each worker thread
+  void work();
+
+  std::vector<std::thread> workers_;
+  std::deque<std::packaged_task<void()>> tasks_;
+  bool stop_;
+  std::mutex mutex_;
+  std::condition_variable task_added_;
+};  // ThreadPool
+
+// Returns a pool shared by the whole library, which is created on
+// first use with one thread per hardware thread.
+ThreadPool& default_thread_pool();
+
+};      // namespace exdir
+#endif  // EXDIR_THREAD_POOL_H
@@ -0,0 +1,93 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#ifndef EXDIR_TREE_BACKEND_H
+#define EXDIR_TREE_BACKEND_H
+
+#include <exdir/backend.hpp>
+
+#include <cstdint>
+#include <map>
+#include <shared_mutex>
+
+namespace exdir {
+
+// Base for backends which hold the directory tree of an exdir file in
+// memory, as a map of entries keyed by path. Missing parent directories
+// are created implicitly. File contents are either owned by the entry,
+// or point to memory owned by the derived backend.
+class TreeBackend : public Backend {
+ public:
+  TreeBackend() = default;
+  virtual ~TreeBackend() = default;
+
+  bool exists(const std::filesystem::path& p) const override;
+
+  bool is_directory(const std::filesystem::path& p) const override;
+
+  void create_directory(const std::filesystem::path& p) override;
+
+  std::vector<std::string> list_directory(
+      const std::filesystem::path& p) const override;
+
+  std::string read_file(const std::filesystem::path& p) const override;
+
+  std::size_t file_size(const std::filesystem::path& p) const override;
+
+  void read_bytes(const std::filesystem::path& p, std::size_t offset,
+                  std::size_t size, char* buffer) const override;
+
+  std::string file_version(const std::filesystem::path& p) const override;
+
+  void write_file(const std::filesystem::path& p,
+                  const std::string& contents) override;
+
+ protected:
+  struct Entry {
+    bool directory;
+    // Owned contents, only used when external is null
+    std::string contents;
+    // Contents held outside of the entry, i.e. in a memory mapping
+    const char* external;
+    std::size_t size;
+    // Taken from next_version_ whenever the entry is written
+    std::uint64_t version;
+
+    const char* data() const {
+      return external != nullptr ? external : contents.data();
+    }
+  };
+
+  // Converts a path to the key used in the entry map. The empty key
+  // is the root directory, which always exists.
+  static std::string entry_key(const std::filesystem::path& p);
+
+  // Creates the directory key and any missing parents. The
+  // caller must hold a unique lock on mutex_.
+  void make_directory(const std::string& key);
+
+  // Returns the file entry at p, or throws if there is no such file. The
+  // caller must hold a lock on mutex_.
+  const Entry& find_file(const std::filesystem::path& p) const;
+
+  // Entries keyed by their normalized generic path
+  std::map<std::string, Entry> entries_;
+  // Guards entries_, next_version_ and modified_, shared for reads and
+  // unique for writes
+  mutable std::shared_mutex mutex_;
+  // Version given to the next entry which is written
+  std::uint64_t next_version_ = 1;
+  // Set whenever an entry is added or replaced
+  bool modified_ = false;
+};  // TreeBackend
+
+};      // namespace exdir
+#endif  // EXDIR_TREE_BACKEND_H
@@ -0,0 +1,294 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#include <exdir/archive_backend.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define EXDIR_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace exdir {
+
+namespace {
+const char ARCHIVE_MAGIC[8] = {'E', 'X', 'D', 'I', 'R', 'A', 'R', 'C'};
+const std::uint64_t ARCHIVE_VERSION = 1;
+const std::uint64_t ARCHIVE_HEADER_SIZE = 32;
+const std::uint64_t ARCHIVE_ALIGNMENT = 64;
+
+void write_u64(std::ostream& out, std::uint64_t val) {
+  char bytes[8];
+  for (std::size_t i = 0; i < 8; i++) {
+    bytes[i] = static_cast<char>((val >> (8 * i)) & 0xFF);
+  }
+  out.write(bytes, 8);
+}
+
+std::uint64_t read_u64(const char* data, std::size_t size, std::size_t& pos) {
+  if (pos + 8 > size) throw std::runtime_error("Exdir archive is truncated.");
+  std::uint64_t val = 0;
+  for (std::size_t i = 0; i < 8; i++) {
+    val |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[pos + i]))
+           << (8 * i);
+  }
+  pos += 8;
+  return val;
+}
+
+// Flushes the file or directory p to the disk, so that it survives a crash.
+void sync_path(const std::filesystem::path& p) {
+#ifdef EXDIR_USE_MMAP
+  int flags = std::filesystem::is_directory(p) ? O_RDONLY : O_WRONLY;
+  int fd = ::open(p.c_str(), flags);
+  if (fd < 0 || ::fsync(fd) != 0) {
+    if (fd >= 0) ::close(fd);
+    std::string mssg = "Could not sync " + p.string() + " to disk.";
+    throw std::runtime_error(mssg);
+  }
+  ::close(fd);
+#else
+  (void)p;
+#endif
+}
+}  // namespace
+
+ArchiveBackend::ArchiveBackend(std::filesystem::path i_archive)
+    : TreeBackend(), archive_(i_archive), mapping_() {
+  if (std::filesystem::exists(archive_)) {
+    Mapping mapping = map_archive();
+    try {
+      entries_ = read_index(mapping);
+    } catch (...) {
+      unmap(mapping);
+      throw;
+    }
+    mapping_ = std::move(mapping);
+
+    // Entries written from now on must get versions which were never used
+    for (const auto& entry : entries_) {
+      next_version_ = std::max(next_version_, entry.second.version + 1);
+    }
+  }
+}
+
+ArchiveBackend::~ArchiveBackend() {
+  // Destructors must not throw. Call flush() directly to catch errors.
+  try {
+    flush();
+  } catch (...) {
+  }
+  unmap(mapping_);
+}
+
+ArchiveBackend::Mapping ArchiveBackend::map_archive() const {
+  Mapping mapping;
+#ifdef EXDIR_USE_MMAP
+  int fd = ::open(archive_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::string mssg = "Could not open archive " + archive_.string() + ".";
+    throw std::runtime_error(mssg);
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    std::string mssg = "Could not stat archive " + archive_.string() + ".";
+    throw std::runtime_error(mssg);
+  }
+  mapping.size = static_cast<std::size_t>(st.st_size);
+  if (mapping.size > 0) {
+    void* addr = ::mmap(nullptr, mapping.size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+      ::close(fd);
+      std::string mssg = "Could not map archive " + archive_.string() + ".";
+      throw std::runtime_error(mssg);
+    }
+    mapping.data = static_cast<const char*>(addr);
+  }
+  ::close(fd);
+#else
+  std::ifstream file(archive_, std::ios::binary);
+  mapping.buffer.assign(std::istreambuf_iterator<char>(file),
+                        std::istreambuf_iterator<char>());
+  mapping.data = mapping.buffer.data();
+  mapping.size = mapping.buffer.size();
+#endif
+  return mapping;
+}
+
+void ArchiveBackend::unmap(Mapping& mapping) {
+#ifdef EXDIR_USE_MMAP
+  if (mapping.data != nullptr) {
+    ::munmap(const_cast<char*>(mapping.data), mapping.size);
+  }
+#endif
+  mapping.buffer.clear();
+  mapping.data = nullptr;
+  mapping.size = 0;
+}
+
+std::map<std::string, TreeBackend::Entry> ArchiveBackend::read_index(
+    const Mapping& mapping) const {
+  const char* data = mapping.data;
+  std::size_t size = mapping.size;
+
+  // Read the header
+  if (size < ARCHIVE_HEADER_SIZE || std::memcmp(data, ARCHIVE_MAGIC, 8) != 0) {
+    std::string mssg = archive_.string() + " is not an exdir archive.";
+    throw std::runtime_error(mssg);
+  }
+  std::size_t pos = 8;
+  std::uint64_t version = read_u64(data, size, pos);
+  std::uint64_t index_offset = read_u64(data, size, pos);
+  std::uint64_t n_entries = read_u64(data, size, pos);
+  if (version != ARCHIVE_VERSION) {
+    std::string mssg = archive_.string() + " has an unknown archive version.";
+    throw std::runtime_error(mssg);
+  }
+
+  // Read the index
+  std::map<std::string, Entry> entries;
+  pos = static_cast<std::size_t>(index_offset);
+  for (std::uint64_t i = 0; i < n_entries; i++) {
+    if (pos + 1 > size) throw std::runtime_error("Exdir archive is truncated.");
+    bool directory = data[pos] == 0;
+    pos++;
+    std::uint64_t path_len = read_u64(data, size, pos);
+    if (pos + path_len > size)
+      throw std::runtime_error("Exdir archive is truncated.");
+    std::string key(data + pos, static_cast<std::size_t>(path_len));
+    pos += static_cast<std::size_t>(path_len);
+    std::uint64_t offset = read_u64(data, size, pos);
+    std::uint64_t entry_size = read_u64(data, size, pos);
+    std::uint64_t entry_version = read_u64(data, size, pos);
+    if (offset + entry_size > size)
+      throw std::runtime_error("Exdir archive is truncated.");
+
+    entries[key] = Entry{directory, std::string(),
+                         directory ? nullptr : data + offset,
+                         static_cast<std::size_t>(entry_size), entry_version};
+  }
+  return entries;
+}
+
+void ArchiveBackend::prefetch(const std::filesystem::path& p) const {
+#ifdef EXDIR_USE_MMAP
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = entries_.find(entry_key(p));
+  if (it == entries_.end() || it->second.external == nullptr ||
+      it->second.size == 0)
+    return;
+
+  // madvise requires a page aligned address
+  std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  std::size_t start =
+      static_cast<std::size_t>(it->second.external - mapping_.data);
+  std::size_t aligned = start - start % page;
+  std::size_t length = start + static_cast<std::size_t>(it->second.size) - aligned;
+  ::madvise(const_cast<char*>(mapping_.data + aligned), length, MADV_WILLNEED);
+#else
+  (void)p;
+#endif
+}
+
+void ArchiveBackend::flush() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (!modified_) return;
+
+  // The new archive is written next to the old one, synced to disk, and
+  // then renamed over it, so that a failed flush or a crash never leaves
+  // behind a corrupted archive. Without POSIX, the data is not synced, and
+  // only a failed flush is safe.
+  std::filesystem::path tmp_path = archive_;
+  tmp_path += ".tmp";
+  std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+  if (!out.good()) {
+    std::string mssg = "Could not open " + tmp_path.string() + " for writing.";
+    throw std::runtime_error(mssg);
+  }
+
+  // Header is rewritten once the index offset is known
+  out.write(ARCHIVE_MAGIC, 8);
+  write_u64(out, ARCHIVE_VERSION);
+  write_u64(out, 0);
+  write_u64(out, 0);
+
+  std::map<std::string, std::uint64_t> offsets;
+  std::uint64_t pos = ARCHIVE_HEADER_SIZE;
+  const char padding[ARCHIVE_ALIGNMENT] = {};
+  for (const auto& entry : entries_) {
+    if (entry.second.directory) continue;
+
+    std::uint64_t pad = (ARCHIVE_ALIGNMENT - pos % ARCHIVE_ALIGNMENT) %
+                        ARCHIVE_ALIGNMENT;
+    out.write(padding, static_cast<std::streamsize>(pad));
+    pos += pad;
+
+    offsets[entry.first] = pos;
+    out.write(entry.second.data(),
+              static_cast<std::streamsize>(entry.second.size));
+    pos += entry.second.size;
+  }
+
+  std::uint64_t index_offset = pos;
+  for (const auto& entry : entries_) {
+    out.put(entry.second.directory ? 0 : 1);
+    write_u64(out, entry.first.size());
+    out.write(entry.first.data(),
+              static_cast<std::streamsize>(entry.first.size()));
+    write_u64(out, entry.second.directory ? 0 : offsets[entry.first]);
+    write_u64(out, entry.second.size);
+    write_u64(out, entry.second.version);
+  }
+
+  out.seekp(16);
+  write_u64(out, index_offset);
+  write_u64(out, entries_.size());
+  out.close();
+  if (!out.good()) {
+    std::string mssg = "Could not write archive " + tmp_path.string() + ".";
+    throw std::runtime_error(mssg);
+  }
+
+  // Swap in the new archive. The old mapping stays valid even once it has
+  // been replaced on disk, so the new one is only swapped in after it has
+  // been mapped and read without error. The old entries hold the same
+  // contents as the new archive, and may be kept if that fails.
+  sync_path(tmp_path);
+  std::filesystem::rename(tmp_path, archive_);
+  // The rename itself is only durable once the directory is synced
+  sync_path(archive_.parent_path().empty() ? std::filesystem::path(".")
+                                           : archive_.parent_path());
+  modified_ = false;
+
+  Mapping mapping = map_archive();
+  std::map<std::string, Entry> entries;
+  try {
+    entries = read_index(mapping);
+  } catch (...) {
+    unmap(mapping);
+    throw;
+  }
+  entries_.swap(entries);
+  std::swap(mapping_, mapping);
+  unmap(mapping);
+}
+
+};  // namespace exdir
@@ -10,49 +10,61 @@
  *
  * */
 #include <exdir/dataset.hpp>
+#include <exdir/dataset_statistics.hpp>
+#include <exdir/npy.hpp>
 
 namespace exdir {
 
 template<class T>
-Dataset<T>::Dataset(std::filesystem::path i_path) : Object(i_path), data(), raws_() {
+Dataset<T>::Dataset(std::filesystem::path i_path, std::shared_ptr<Backend> i_backend) : Object(i_path, i_backend), data(), raws_() {
   if (!is_dataset()) {
     std::string mssg = path_.string() + " does not contain a Dataset object.";
     throw std::runtime_error(mssg);
   }
 
   // Make sure data.npy is present
-  if (!std::filesystem::exists(path_ / "data.npy")) {
+  if (!backend_->exists(path_ / "data.npy")) {
     std::string mssg = (path_ / "data.npy").string() + " does not exists.";
     throw std::runtime_error(mssg);
   }
 
   // Load data
-  data = NDArray<T>::load((path_/"data.npy").string());
+  data = read_npy<T>(*backend_, path_ / "data.npy");
 
+  raws_ = find_raws(*backend_, path_);
+}
+
+template<class T>
+Dataset<T>::Dataset(std::filesystem::path i_path, std::shared_ptr<Backend> i_backend, Metadata&& i_metadata, std::vector<std::string>&& i_raws, NDArray<T>&& i_data) : Object(i_path, i_backend, std::move(i_metadata)), data(std::move(i_data)), raws_(std::move(i_raws)) {
+  if (!is_dataset()) {
+    std::string mssg = path_.string() + " does not contain a Dataset object.";
+    throw std::runtime_error(mssg);
+  }
+}
+
+template<class T>
+std::vector<std::string> Dataset<T>::find_raws(const Backend& backend, const std::filesystem::path& path) {
+  std::vector<std::string> raws;
   // Get any raw folders in directory
   // Look at all members in file, check if folder
-  for (auto& f : std::filesystem::directory_iterator(path_)) {
-    if (std::filesystem::is_directory(f.status())) {
+  for (const auto& f : backend.list_directory(path)) {
+    if (backend.is_directory(path / f)) {
       // Is a directory, must be raw if in dataset
-      raws_.push_back(f.path().filename().string());
+      raws.push_back(f);
     }
   }
+  return raws;
 }
 
 template<class T>
 Raw Dataset<T>::create_raw(const std::string& name) {
   // Make sure directory does not yet exists
-  if (!std::filesystem::exists(path_ / name)) {
+  if (!backend_->exists(path_ / name)) {
     // Make directory
-    std::filesystem::create_directory(path_ / name);
+    backend_->create_directory(path_ / name);
 
     // Make exdir.yaml file for directory
-    std::ofstream exdir_yaml(path_ / name / "exdir.yaml");
-    exdir_yaml << "exdir:";
-    // TODO put version in a header eventuall
-    exdir_yaml << "  version: " << 1 << "\n";
-    exdir_yaml << "  type: \"raw\"";
-    exdir_yaml.close();
+    backend_->write_file(path_ / name / "exdir.yaml", exdir_yaml("raw"));
 
     // Add raw name to raws_ for latter
     raws_.push_back(name);
@@ -71,7 +83,7 @@ Raw Dataset<T>::get_raw(const std::string& name) const {
   // Make sure in raws_
   for (const auto& raw : raws_) {
     if (name == raw) {
-      return exdir::Raw(path_ / name);
+      return exdir::Raw(path_ / name, backend_);
     }
   }
   // throw error, wasn't valid Raw
@@ -82,14 +94,18 @@ Raw Dataset<T>::get_raw(const std::string& name) const {
 
 template <class T>
 void Dataset<T>::write() {
+  // Nothing to write for a dataset which was moved from
+  if (!backend_) return;
+
   // Write data to npy file
-  data.save((path_/"data.npy").string()); 
+  // Statistics are rewritten with the data, so they are never stale
+  std::string npy = npy_encode(data);
+  backend_->write_file(path_ / "data.npy", npy);
+  write_npy_statistics<T>(*backend_, path_, npy, default_thread_pool);
 
   // Write attributes as well
   if (!attrs.IsNull()) {
-    std::ofstream attributes_yaml(path_ / "attributes.yaml");
-    attributes_yaml << attrs;
-    attributes_yaml.close();
+    backend_->write_file(path_ / "attributes.yaml", YAML::Dump(attrs));
   }
 }
 
@@ -0,0 +1,76 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#include <exdir/dataset_statistics.hpp>
+
+namespace exdir {
+
+YAML::Node DatasetStatistics::to_yaml() const {
+  YAML::Node node;
+  node["count"] = count;
+  node["nan_count"] = nan_count;
+  node["min"] = min;
+  node["max"] = max;
+  node["mean"] = mean;
+  node["data_version"] = data_version;
+  node["block_size"] = block_size;
+  node["block_min"] = block_min;
+  node["block_max"] = block_max;
+  node["block_min"].SetStyle(YAML::EmitterStyle::Flow);
+  node["block_max"].SetStyle(YAML::EmitterStyle::Flow);
+  return node;
+}
+
+DatasetStatistics DatasetStatistics::from_yaml(const YAML::Node& node) {
+  DatasetStatistics stats;
+  stats.count = node["count"].as<std::size_t>();
+  stats.nan_count = node["nan_count"].as<std::size_t>();
+  stats.min = node["min"].as<double>();
+  stats.max = node["max"].as<double>();
+  stats.mean = node["mean"].as<double>();
+  stats.data_version = node["data_version"].as<std::string>();
+  stats.block_size = node["block_size"].as<std::size_t>();
+  stats.block_min = node["block_min"].as<std::vector<double>>();
+  stats.block_max = node["block_max"].as<std::vector<double>>();
+
+  if (stats.block_min.size() != stats.block_max.size()) {
+    throw std::runtime_error("statistics.yaml has mismatched blocks.");
+  }
+  return stats;
+}
+
+std::optional<DatasetStatistics> read_statistics(
+    const Backend& backend, const std::filesystem::path& dir) {
+  if (!backend.exists(dir / "statistics.yaml") ||
+      !backend.exists(dir / "data.npy")) {
+    return std::nullopt;
+  }
+
+  DatasetStatistics stats;
+  try {
+    stats = DatasetStatistics::from_yaml(
+        YAML::Load(backend.read_file(dir / "statistics.yaml")));
+  } catch (const std::exception&) {
+    // Unreadable statistics are treated as missing
+    return std::nullopt;
+  }
+
+  // data.npy was modified by something other than exdir-cpp, or the
+  // backend can not tell
+  if (stats.data_version.empty() ||
+      stats.data_version != backend.file_version(dir / "data.npy")) {
+    return std::nullopt;
+  }
+
+  return stats;
+}
+
+};  // namespace exdir
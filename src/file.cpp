@@ -13,7 +13,7 @@
 
 namespace exdir {
 
-File::File(std::filesystem::path i_path) : Group(i_path) {
+File::File(std::filesystem::path i_path, std::shared_ptr<Backend> i_backend) : Group(i_path, i_backend) {
   // Use is_file() to make sure a File object was loaded.
   if (!is_file()) {
     std::string mssg = path_.string() + " does not contain a File object.";
@@ -21,22 +21,17 @@ File::File(std::filesystem::path i_path) : Group(i_path) {
   }
 }
 
-File create_file(std::filesystem::path name) {
+File create_file(std::filesystem::path name, std::shared_ptr<Backend> backend) {
   // Make sure directory does not yet exists
-  if (!std::filesystem::exists(name)) {
+  if (!backend->exists(name)) {
     // Make directory
-    std::filesystem::create_directory(name);
+    backend->create_directory(name);
 
     // Make exdir.yaml file for directory
-    std::ofstream exdir_yaml(name / "exdir.yaml");
-    exdir_yaml << "exdir:\n";
-    // TODO put version in a header eventuall
-    exdir_yaml << "  version: " << 1 << "\n";
-    exdir_yaml << "  type: \"file\"";
-    exdir_yaml.close();
+    backend->write_file(name / "exdir.yaml", exdir_yaml("file"));
 
     // Return file
-    return File(name);
+    return File(name, backend);
 
   } else {
     std::string mssg = "The directory " + name.string() + " already exists.";
@@ -11,9 +11,12 @@
  * */
 #include <exdir/group.hpp>
 
+#include <condition_variable>
+#include <mutex>
+
 namespace exdir {
 
-Group::Group(std::filesystem::path i_path) : Object(i_path), groups_(), raws_(), datasets_() {
+Group::Group(std::filesystem::path i_path, std::shared_ptr<Backend> i_backend) : Object(i_path, i_backend), groups_(), raws_(), datasets_() {
   // use is_group() and is_file() to make sure group object was loaded.
   if (!is_group()) {
     std::string mssg = path_.string() + " does not contain a Group object.";
@@ -21,17 +24,15 @@ Group::Group(std::filesystem::path i_path) : Object(i_path), groups_(), raws_(),
   }
 
   // Look at all members in file, check if folder
-  for (auto& f : std::filesystem::directory_iterator(path_)) {
-    if (std::filesystem::is_directory(f.status())) {
+  for (const auto& node_name : backend_->list_directory(path_)) {
+    std::filesystem::path f = path_ / node_name;
+    if (backend_->is_directory(f)) {
       // Is a directory, check if exdir.yaml exists
-      if (std::filesystem::exists(f.path() / "exdir.yaml")) {
+      if (backend_->exists(f / "exdir.yaml")) {
         YAML::Node daughter_node =
-            YAML::LoadFile((f.path() / "exdir.yaml").string());
+            YAML::Load(backend_->read_file(f / "exdir.yaml"));
 
         if (daughter_node["exdir"] && daughter_node["exdir"]["type"]) {
-          // f.path() yields /dir/to/parent/current_node/daughter_node
-          // Using f.path().filename() yields daughter_node as path
-          std::string node_name = f.path().filename().string();
 
           if (daughter_node["exdir"]["type"].as<std::string>() == "group")
             groups_.push_back(node_name);
@@ -42,18 +43,18 @@ Group::Group(std::filesystem::path i_path) : Object(i_path), groups_(), raws_(),
             raws_.push_back(node_name);
           else {
             // throw error, unknown type
-            std::string mssg = f.path().string() + " has an undefined type.";
+            std::string mssg = f.string() + " has an undefined type.";
             throw std::runtime_error(mssg);
           }
 
         } else {
           // throw error, bad exdir.yaml
-          std::string mssg = f.path().string() + " exdir.yaml file is invalid.";
+          std::string mssg = f.string() + " exdir.yaml file is invalid.";
           throw std::runtime_error(mssg);
         }
       } else {
         // No exdir.yaml, must be a raw, save to raw vector
-        raws_.push_back(f.path().filename().string());
+        raws_.push_back(node_name);
       }
     }
   }
@@ -61,17 +62,12 @@ Group::Group(std::filesystem::path i_path) : Object(i_path), groups_(), raws_(),
 
 Group Group::create_group(const std::string& name) {
   // Make sure directory does not yet exists
-  if (!std::filesystem::exists(path_ / name)) {
+  if (!backend_->exists(path_ / name)) {
     // Make directory
-    std::filesystem::create_directory(path_ / name);
+    backend_->create_directory(path_ / name);
 
     // Make exdir.yaml file for directory
-    std::ofstream exdir_yaml(path_ / name / "exdir.yaml");
-    exdir_yaml << "exdir:\n";
-    // TODO put version in a header eventuall
-    exdir_yaml << "  version: " << 1 << "\n";
-    exdir_yaml << "  type: \"group\"";
-    exdir_yaml.close();
+    backend_->write_file(path_ / name / "exdir.yaml", exdir_yaml("group"));
 
     // Add raw name to raws_ for latter
     groups_.push_back(name);
@@ -87,17 +83,12 @@ Group Group::create_group(const std::string& name) {
 
 Raw Group::create_raw(const std::string& name) {
   // Make sure directory does not yet exists
-  if (!std::filesystem::exists(path_ / name)) {
+  if (!backend_->exists(path_ / name)) {
     // Make directory
-    std::filesystem::create_directory(path_ / name);
+    backend_->create_directory(path_ / name);
 
     // Make exdir.yaml file for directory
-    std::ofstream exdir_yaml(path_ / name / "exdir.yaml");
-    exdir_yaml << "exdir:\n";
-    // TODO put version in a header eventuall
-    exdir_yaml << "  version: " << 1 << "\n";
-    exdir_yaml << "  type: \"raw\"";
-    exdir_yaml.close();
+    backend_->write_file(path_ / name / "exdir.yaml", exdir_yaml("raw"));
 
     // Add raw name to raws_ for latter
     raws_.push_back(name);
@@ -111,11 +102,113 @@ Raw Group::create_raw(const std::string& name) {
   return get_raw(name);
 }
 
+void Group::create_datasets(const DatasetWriteBatch& batch, ThreadPool& pool,
+                            std::size_t max_inflight_bytes) {
+  std::vector<std::pair<std::string, std::string>> failures;
+  std::vector<std::pair<std::size_t, std::future<void>>> writes;
+
+  // Bytes of data currently being written
+  std::size_t inflight_bytes = 0;
+  std::mutex inflight_mutex;
+  std::condition_variable write_done;
+
+  // Queued writes refer to variables on this stack, so every one of them
+  // must finish before this function may exit, even by an exception.
+  writes.reserve(batch.entries_.size());
+  try {
+    for (std::size_t i = 0; i < batch.entries_.size(); i++) {
+      const auto& entry = batch.entries_[i];
+
+      // Make sure directory does not yet exists, nor is in the batch twice
+      bool exists = false;
+      for (std::size_t j = 0; j < i; j++) {
+        if (batch.entries_[j].name == entry.name) exists = true;
+      }
+      try {
+        exists = exists || backend_->exists(path_ / entry.name);
+      } catch (const std::exception& err) {
+        failures.push_back({entry.name, err.what()});
+        continue;
+      }
+      if (exists) {
+        std::string mssg =
+            "The directory " + entry.name + " already exists in " + path_.string();
+        failures.push_back({entry.name, mssg});
+        continue;
+      }
+
+      // Wait until the data fits within the budget
+      {
+        std::unique_lock<std::mutex> lock(inflight_mutex);
+        write_done.wait(lock, [&] {
+          return inflight_bytes == 0 ||
+                 inflight_bytes + entry.bytes <= max_inflight_bytes;
+        });
+        inflight_bytes += entry.bytes;
+      }
+
+      std::filesystem::path dset_path = path_ / entry.name;
+      std::future<void> write = pool.submit([&, dset_path] {
+        try {
+          // Make directory
+          backend_->create_directory(dset_path);
+
+          // Make exdir.yaml file for directory
+          backend_->write_file(dset_path / "exdir.yaml", exdir_yaml("dataset"));
+
+          // Write data to data.npy, and its summary to statistics.yaml
+          std::string npy = entry.encode();
+          backend_->write_file(dset_path / "data.npy", npy);
+          entry.summarize(*backend_, dset_path, npy);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(inflight_mutex);
+          inflight_bytes -= entry.bytes;
+          write_done.notify_all();
+          throw;
+        }
+
+        std::lock_guard<std::mutex> lock(inflight_mutex);
+        inflight_bytes -= entry.bytes;
+        write_done.notify_all();
+      });
+      // Can not throw, as space was reserved
+      writes.emplace_back(i, std::move(write));
+    }
+  } catch (...) {
+    for (auto& write : writes) write.second.wait();
+    throw;
+  }
+
+  // Wait for all writes, even once one has failed
+  for (auto& write : writes) write.second.wait();
+  for (auto& write : writes) {
+    const std::string& name = batch.entries_[write.first].name;
+    try {
+      write.second.get();
+      datasets_.push_back(name);
+    } catch (const std::exception& err) {
+      failures.push_back({name, err.what()});
+    } catch (...) {
+      failures.push_back({name, "Unknown error."});
+    }
+  }
+
+  if (!failures.empty()) throw BatchWriteError(failures);
+}
+
+std::optional<DatasetStatistics> Group::get_statistics(const std::string& name) const {
+  if (std::find(datasets_.begin(), datasets_.end(), name) == datasets_.end()) {
+    std::string mssg = "The Dataset " + name + " is not a member of this Group.";
+    throw std::runtime_error(mssg);
+  }
+  return read_statistics(*backend_, path_ / name);
+}
+
 Group Group::get_group(const std::string& name) const {
   // Make sure in groups_
   for (const auto& group : groups_) {
     if (name == group) {
-      return Group(path_ / name);
+      return Group(path_ / name, backend_);
     }
   }
   // throw error, wasn't a valid group
@@ -128,7 +221,7 @@ Raw Group::get_raw(const std::string& name) const {
   // Make sure in raws_
   for (const auto& raw : raws_) {
     if (name == raw) {
-      return exdir::Raw(path_ / name);
+      return exdir::Raw(path_ / name, backend_);
     }
   }
   // throw error, wasn't valid Raw
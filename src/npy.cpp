@@ -0,0 +1,193 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#include <exdir/npy.hpp>
+
+#include <cstdint>
+
+namespace exdir {
+
+namespace {
+const char NPY_MAGIC[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+const std::size_t NPY_ALIGNMENT = 64;
+
+// Returns the text following 'key': in the header dictionary.
+std::string npy_dict_value(const std::string& dict, const std::string& key) {
+  std::size_t pos = dict.find("'" + key + "'");
+  if (pos == std::string::npos) {
+    std::string mssg = "npy header is missing the " + key + " key.";
+    throw std::runtime_error(mssg);
+  }
+  pos = dict.find(':', pos);
+  if (pos == std::string::npos) {
+    std::string mssg = "npy header has no value for the " + key + " key.";
+    throw std::runtime_error(mssg);
+  }
+  pos = dict.find_first_not_of(' ', pos + 1);
+  if (pos == std::string::npos) {
+    std::string mssg = "npy header has no value for the " + key + " key.";
+    throw std::runtime_error(mssg);
+  }
+  return dict.substr(pos);
+}
+}  // namespace
+
+bool host_is_little_endian() {
+  const std::uint16_t one = 1;
+  unsigned char first;
+  std::memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+NpyHeader parse_npy_header(const char* data, std::size_t size) {
+  return parse_npy_header(data, size, size);
+}
+
+NpyHeader parse_npy_header(const char* data, std::size_t size,
+                           std::size_t file_size) {
+  if (size < 10 || std::memcmp(data, NPY_MAGIC, 6) != 0) {
+    throw std::runtime_error("Data is not in the npy format.");
+  }
+
+  // Version 1 uses a 2 byte header length, versions 2 and 3 use 4 bytes
+  unsigned char major = static_cast<unsigned char>(data[6]);
+  std::size_t dict_len = 0;
+  std::size_t dict_start = 0;
+  if (major == 1) {
+    dict_len = static_cast<unsigned char>(data[8]) |
+               static_cast<std::size_t>(static_cast<unsigned char>(data[9]))
+                   << 8;
+    dict_start = 10;
+  } else if (major == 2 || major == 3) {
+    if (size < 12) throw std::runtime_error("npy header is truncated.");
+    for (std::size_t i = 0; i < 4; i++) {
+      dict_len |=
+          static_cast<std::size_t>(static_cast<unsigned char>(data[8 + i]))
+          << (8 * i);
+    }
+    dict_start = 12;
+  } else {
+    std::string mssg =
+        "npy format version " + std::to_string(major) + " is not supported.";
+    throw std::runtime_error(mssg);
+  }
+  if (dict_start + dict_len > size) {
+    throw std::runtime_error("npy header is truncated.");
+  }
+  std::string dict(data + dict_start, dict_len);
+
+  NpyHeader header;
+  header.data_offset = dict_start + dict_len;
+
+  // Data type, i.e. '<f8'
+  std::string descr = npy_dict_value(dict, "descr");
+  std::size_t close = descr.find('\'', 1);
+  if (descr.size() < 4 || descr[0] != '\'' || close == std::string::npos) {
+    throw std::runtime_error("npy header has an invalid descr.");
+  }
+  descr = descr.substr(1, close - 1);
+  header.byte_order = descr[0];
+  if (header.byte_order == '=') {
+    header.byte_order = host_is_little_endian() ? '<' : '>';
+  }
+  header.kind = descr[1];
+  header.item_size = std::stoul(descr.substr(2));
+
+  // Memory order
+  std::string fortran = npy_dict_value(dict, "fortran_order");
+  header.fortran_order = fortran.compare(0, 4, "True") == 0;
+
+  // Shape, i.e. (4, 4)
+  std::string shape = npy_dict_value(dict, "shape");
+  std::size_t shape_end = shape.find(')');
+  if (shape.empty() || shape[0] != '(' || shape_end == std::string::npos) {
+    throw std::runtime_error("npy header has an invalid shape.");
+  }
+  shape = shape.substr(1, shape_end - 1);
+  std::size_t n = 1;
+  std::size_t pos = 0;
+  while ((pos = shape.find_first_of("0123456789", pos)) != std::string::npos) {
+    std::size_t end = shape.find_first_not_of("0123456789", pos);
+    header.shape.push_back(std::stoul(shape.substr(pos, end - pos)));
+    n *= header.shape.back();
+    pos = end;
+  }
+
+  if (header.data_offset + n * header.item_size > file_size) {
+    throw std::runtime_error("npy data is truncated.");
+  }
+
+  return header;
+}
+
+NpyHeader read_npy_header(const Backend& backend,
+                          const std::filesystem::path& p) {
+  std::size_t file_size = backend.file_size(p);
+
+  // The fixed part of the header gives the length of the rest
+  std::string header(std::min<std::size_t>(12, file_size), '\0');
+  backend.read_bytes(p, 0, header.size(), &header[0]);
+  if (header.size() < 10 || std::memcmp(header.data(), NPY_MAGIC, 6) != 0) {
+    std::string mssg = p.string() + " is not in the npy format.";
+    throw std::runtime_error(mssg);
+  }
+  std::size_t header_size =
+      10 + (static_cast<unsigned char>(header[8]) |
+            static_cast<std::size_t>(static_cast<unsigned char>(header[9]))
+                << 8);
+  if (header[6] != '\x01' && header.size() == 12) {
+    header_size = 12;
+    for (std::size_t i = 0; i < 4; i++) {
+      header_size +=
+          static_cast<std::size_t>(static_cast<unsigned char>(header[8 + i]))
+          << (8 * i);
+    }
+  }
+
+  header.resize(std::min(header_size, file_size));
+  backend.read_bytes(p, 0, header.size(), &header[0]);
+  return parse_npy_header(header.data(), header.size(), file_size);
+}
+
+std::string make_npy_header(char kind, std::size_t item_size,
+                            bool fortran_order,
+                            const std::vector<std::size_t>& shape) {
+  char byte_order = '|';
+  if (item_size > 1) byte_order = host_is_little_endian() ? '<' : '>';
+
+  std::string dict = "{'descr': '";
+  dict += byte_order;
+  dict += kind;
+  dict += std::to_string(item_size);
+  dict += "', 'fortran_order': ";
+  dict += fortran_order ? "True" : "False";
+  dict += ", 'shape': (";
+  for (const auto& s : shape) dict += std::to_string(s) + ", ";
+  // Numpy writes 1-d shapes as (n,)
+  if (shape.size() > 1) dict.resize(dict.size() - 2);
+  else if (shape.size() == 1) dict.pop_back();
+  dict += "), }";
+
+  // Pad with spaces and a final newline so the data is aligned
+  std::size_t total = 10 + dict.size() + 1;
+  dict.append((NPY_ALIGNMENT - total % NPY_ALIGNMENT) % NPY_ALIGNMENT, ' ');
+  dict += '\n';
+
+  std::string header(NPY_MAGIC, 6);
+  header += '\x01';
+  header += '\x00';
+  header += static_cast<char>(dict.size() & 0xFF);
+  header += static_cast<char>((dict.size() >> 8) & 0xFF);
+  header += dict;
+  return header;
+}
+
+};  // namespace exdir
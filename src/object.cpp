@@ -13,11 +13,10 @@
 
 namespace exdir {
 
-Object::Object(std::filesystem::path i_path) : attrs(), type_(Type::Raw), path_(i_path), name_(), exdir_info() {
-  // Check if exdir.yaml exists, if so, load into exdir_info
-  if (std::filesystem::exists(path_ / "exdir.yaml")) {
-    exdir_info = YAML::LoadFile((path_ / "exdir.yaml").string());
+Object::Object(std::filesystem::path i_path, std::shared_ptr<Backend> i_backend) : Object(i_path, i_backend, read_metadata(*i_backend, i_path)) {}
 
+Object::Object(std::filesystem::path i_path, std::shared_ptr<Backend> i_backend, Metadata&& i_metadata) : attrs(i_metadata.attrs), type_(Type::Raw), path_(i_path), backend_(i_backend), name_(), exdir_info(i_metadata.exdir_info) {
+  if (i_metadata.has_exdir_yaml) {
     // Set data type from exdir.yaml
     if (exdir_info["exdir"] && exdir_info["exdir"]["type"]) {
       if (exdir_info["exdir"]["type"].as<std::string>() == "file")
@@ -40,19 +39,40 @@ Object::Object(std::filesystem::path i_path) : attrs(), type_(Type::Raw), path_(
 
   // Set name from path
   name_ = path_.filename().string();
+}
+
+Object::Metadata Object::read_metadata(const Backend& backend, const std::filesystem::path& path) {
+  Metadata metadata;
+
+  // Check if exdir.yaml exists, if so, load into exdir_info
+  if (backend.exists(path / "exdir.yaml")) {
+    metadata.has_exdir_yaml = true;
+    metadata.exdir_info = YAML::Load(backend.read_file(path / "exdir.yaml"));
+  }
 
   // Check if attributes.yaml exists. If so, load into attributes
-  if (std::filesystem::exists(path_ / "attributes.yaml")) {
-    attrs = YAML::LoadFile((path_ / "attributes.yaml").string());
+  if (backend.exists(path / "attributes.yaml")) {
+    metadata.attrs = YAML::Load(backend.read_file(path / "attributes.yaml"));
   }
+
+  return metadata;
+}
+
+std::string exdir_yaml(const std::string& type) {
+  std::string contents = "exdir:\n";
+  // TODO put version in a header eventuall
+  contents += "  version: " + std::to_string(1) + "\n";
+  contents += "  type: \"" + type + "\"";
+  return contents;
 }
 
 void Object::write() {
+  // Nothing to write for an object which was moved from
+  if (!backend_) return;
+
   // Write attributes to file
   if (!attrs.IsNull()) {
-    std::ofstream attributes_yaml(path_ / "attributes.yaml");
-    attributes_yaml << attrs;
-    attributes_yaml.close();
+    backend_->write_file(path_ / "attributes.yaml", YAML::Dump(attrs));
   }
 }
 };  // namespace exdir
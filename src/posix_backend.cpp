@@ -0,0 +1,137 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#include <exdir/posix_backend.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace exdir {
+
+bool PosixBackend::exists(const std::filesystem::path& p) const {
+  return std::filesystem::exists(p);
+}
+
+bool PosixBackend::is_directory(const std::filesystem::path& p) const {
+  return std::filesystem::is_directory(p);
+}
+
+void PosixBackend::create_directory(const std::filesystem::path& p) {
+  std::filesystem::create_directory(p);
+}
+
+std::vector<std::string> PosixBackend::list_directory(
+    const std::filesystem::path& p) const {
+  std::vector<std::string> names;
+  for (const auto& f : std::filesystem::directory_iterator(p)) {
+    names.push_back(f.path().filename().string());
+  }
+  return names;
+}
+
+std::string PosixBackend::read_file(const std::filesystem::path& p) const {
+  std::ifstream file(p, std::ios::binary);
+  if (!file.good()) {
+    std::string mssg = "Could not open " + p.string() + " for reading.";
+    throw std::runtime_error(mssg);
+  }
+
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+std::size_t PosixBackend::file_size(const std::filesystem::path& p) const {
+  return static_cast<std::size_t>(std::filesystem::file_size(p));
+}
+
+void PosixBackend::read_bytes(const std::filesystem::path& p,
+                              std::size_t offset, std::size_t size,
+                              char* buffer) const {
+  std::ifstream file(p, std::ios::binary);
+  if (!file.good()) {
+    std::string mssg = "Could not open " + p.string() + " for reading.";
+    throw std::runtime_error(mssg);
+  }
+
+  file.seekg(static_cast<std::streamoff>(offset));
+  file.read(buffer, static_cast<std::streamsize>(size));
+  if (static_cast<std::size_t>(file.gcount()) != size) {
+    std::string mssg = "Could not read " + std::to_string(size) +
+                       " bytes from " + p.string() + ".";
+    throw std::runtime_error(mssg);
+  }
+}
+
+std::string PosixBackend::file_version(const std::filesystem::path& p) const {
+#if defined(__unix__) || defined(__APPLE__)
+  // The change time is updated by every write, and can not be set back by
+  // the user like the modification time. The inode changes when the file
+  // is replaced by a rename.
+  struct stat st;
+  if (::stat(p.c_str(), &st) != 0) {
+    std::string mssg = "Could not stat " + p.string() + ".";
+    throw std::runtime_error(mssg);
+  }
+#if defined(__APPLE__)
+  const struct timespec& mtime = st.st_mtimespec;
+  const struct timespec& ctime = st.st_ctimespec;
+#else
+  const struct timespec& mtime = st.st_mtim;
+  const struct timespec& ctime = st.st_ctim;
+#endif
+  return std::to_string(st.st_dev) + ":" + std::to_string(st.st_ino) + ":" +
+         std::to_string(st.st_size) + ":" + std::to_string(mtime.tv_sec) +
+         "." + std::to_string(mtime.tv_nsec) + ":" +
+         std::to_string(ctime.tv_sec) + "." + std::to_string(ctime.tv_nsec);
+#else
+  auto mtime = std::filesystem::last_write_time(p).time_since_epoch().count();
+  return std::to_string(std::filesystem::file_size(p)) + ":" +
+         std::to_string(mtime);
+#endif
+}
+
+void PosixBackend::prefetch(const std::filesystem::path& p) const {
+#if defined(POSIX_FADV_WILLNEED)
+  // Ask the kernel to start reading the file into the page cache
+  int fd = ::open(p.c_str(), O_RDONLY);
+  if (fd < 0) return;
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  ::close(fd);
+#else
+  (void)p;
+#endif
+}
+
+void PosixBackend::write_file(const std::filesystem::path& p,
+                              const std::string& contents) {
+  std::ofstream file(p, std::ios::binary | std::ios::trunc);
+  if (!file.good()) {
+    std::string mssg = "Could not open " + p.string() + " for writing.";
+    throw std::runtime_error(mssg);
+  }
+
+  file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  file.close();
+  if (!file.good()) {
+    std::string mssg = "Could not write " + p.string() + ".";
+    throw std::runtime_error(mssg);
+  }
+}
+
+};  // namespace exdir
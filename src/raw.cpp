@@ -13,7 +13,7 @@
 
 namespace exdir {
 
-Raw::Raw(std::filesystem::path i_path) : Object(i_path) {
+Raw::Raw(std::filesystem::path i_path, std::shared_ptr<Backend> i_backend) : Object(i_path, i_backend) {
   // use is_raw() to make sure a Raw object was loaded
   if (!is_raw()) {
     std::string mssg = path_.string() + " does not contian a Raw object.";
@@ -22,11 +22,6 @@ Raw::Raw(std::filesystem::path i_path) : Object(i_path) {
 }
 
 std::vector<std::string> Raw::member_files() const {
-  // Initialize empty vector
-  std::vector<std::string> files;
-  for (const auto& f : std::filesystem::directory_iterator(path_)) {
-    files.push_back(f.path().filename().string());
-  }
-  return files;
+  return backend_->list_directory(path_);
 }
 };  // namespace exdir
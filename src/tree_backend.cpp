@@ -0,0 +1,152 @@
+/*
+ * exdir-cpp
+ *
+ * Copyright (C) 2020, Hunter Belanger (hunter.belanger@gmail.com)
+ * All rights reserved.
+ *
+ * Released under the terms and conditions of the BSD 3-Clause license.
+ * For more information, refer to the GitHub repo for this library at:
+ * https://github.com/HunterBelanger/exdir-cpp
+ *
+ * */
+#include <exdir/tree_backend.hpp>
+
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace exdir {
+
+std::string TreeBackend::entry_key(const std::filesystem::path& p) {
+  std::string key = p.lexically_normal().generic_string();
+  while (!key.empty() && key.back() == '/') key.pop_back();
+  if (key == ".") key.clear();
+  return key;
+}
+
+bool TreeBackend::exists(const std::filesystem::path& p) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  std::string key = entry_key(p);
+  return key.empty() || entries_.find(key) != entries_.end();
+}
+
+bool TreeBackend::is_directory(const std::filesystem::path& p) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  std::string key = entry_key(p);
+  if (key.empty()) return true;
+  auto it = entries_.find(key);
+  return it != entries_.end() && it->second.directory;
+}
+
+void TreeBackend::create_directory(const std::filesystem::path& p) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  make_directory(entry_key(p));
+}
+
+void TreeBackend::make_directory(const std::string& key) {
+  if (key.empty()) return;
+
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    if (!it->second.directory) {
+      std::string mssg = key + " already exists and is not a directory.";
+      throw std::runtime_error(mssg);
+    }
+    return;
+  }
+
+  // Make sure all parents exist as well
+  make_directory(entry_key(std::filesystem::path(key).parent_path()));
+
+  entries_[key] = Entry{true, std::string(), nullptr, 0, next_version_++};
+  modified_ = true;
+}
+
+std::vector<std::string> TreeBackend::list_directory(
+    const std::filesystem::path& p) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  std::string prefix = entry_key(p);
+  auto dir = entries_.find(prefix);
+  if (!prefix.empty() && (dir == entries_.end() || !dir->second.directory)) {
+    std::string mssg = p.string() + " is not a directory.";
+    throw std::runtime_error(mssg);
+  }
+
+  if (!prefix.empty() || p.is_absolute()) prefix += '/';
+
+  // All entries in the directory are contiguous in the map, directly after
+  // the prefix. Only take those with no further separator.
+  std::vector<std::string> names;
+  for (auto it = entries_.lower_bound(prefix); it != entries_.end(); it++) {
+    const std::string& key = it->first;
+    if (key.compare(0, prefix.size(), prefix) != 0) break;
+    std::string name = key.substr(prefix.size());
+    if (!name.empty() && name.find('/') == std::string::npos)
+      names.push_back(name);
+  }
+  return names;
+}
+
+const TreeBackend::Entry& TreeBackend::find_file(
+    const std::filesystem::path& p) const {
+  auto it = entries_.find(entry_key(p));
+  if (it == entries_.end() || it->second.directory) {
+    std::string mssg = "Could not open " + p.string() + " for reading.";
+    throw std::runtime_error(mssg);
+  }
+  return it->second;
+}
+
+std::string TreeBackend::read_file(const std::filesystem::path& p) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  const Entry& entry = find_file(p);
+  return std::string(entry.data(), entry.size);
+}
+
+std::size_t TreeBackend::file_size(const std::filesystem::path& p) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return find_file(p).size;
+}
+
+void TreeBackend::read_bytes(const std::filesystem::path& p,
+                             std::size_t offset, std::size_t size,
+                             char* buffer) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  const Entry& entry = find_file(p);
+  if (offset + size > entry.size) {
+    std::string mssg = "Could not read " + std::to_string(size) +
+                       " bytes from " + p.string() + ".";
+    throw std::runtime_error(mssg);
+  }
+  std::memcpy(buffer, entry.data() + offset, size);
+}
+
+std::string TreeBackend::file_version(const std::filesystem::path& p) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return std::to_string(find_file(p).version);
+}
+
+void TreeBackend::write_file(const std::filesystem::path& p,
+                             const std::string& contents) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  std::string key = entry_key(p);
+  auto it = entries_.find(key);
+  if (key.empty() || (it != entries_.end() && it->second.directory)) {
+    std::string mssg = "Could not open " + p.string() + " for writing.";
+    throw std::runtime_error(mssg);
+  }
+
+  // Objects rewrite their attributes when destroyed. Leaving identical
+  // files untouched keeps a read only session from modifying the tree.
+  if (it != entries_.end() && it->second.size == contents.size() &&
+      std::memcmp(it->second.data(), contents.data(), contents.size()) == 0)
+    return;
+
+  make_directory(entry_key(std::filesystem::path(key).parent_path()));
+
+  entries_[key] =
+      Entry{false, contents, nullptr, contents.size(), next_version_++};
+  modified_ = true;
+}
+
+};  // namespace exdir